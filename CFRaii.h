@@ -14,6 +14,8 @@
 
 #include "QCTypeTraits.h"
 #include "QCSharedPtr.h"
+#include "QCRef.h"
+#include "QCArenaAllocator.h"
 #include "QCUtilities.h"
 
 #include "QCArray.h"
@@ -26,6 +28,13 @@
 #include "QCSet.h"
 #include "QCStack.h"
 #include "QCString.h"
+#include "QCStringBuilder.h"
+#include "QCStringPool.h"
+#include "QCStringView.h"
+#include "QCPatternMatcher.h"
+#include "QCStringCompare.h"
+#include "QCParallelSort.h"
+#include "QCTypedArray.h"
 #include "QCURL.h"
 
 #endif
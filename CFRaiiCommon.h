@@ -12,6 +12,8 @@
 
 #include <CoreFoundation/CoreFoundation.h>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 
 #import "QCMacrosInternal.h"
 
@@ -60,6 +62,119 @@ inline void Release(CFTypeRef object)
 	if (isNotNull(object)) CFRelease(object);
 }
 
+/*
+ * Copy-on-write bookkeeping for the mutable reference a wrapper holds.
+ * The wrapper tracks this itself rather than asking CFGetRetainCount,
+ * which also counts retains we know nothing about.
+ */
+enum QCOwnership
+{
+	kQCOwnedUnique,		// created by this wrapper and never handed to another; mutate in place
+	kQCShared,			// another wrapper holds the same reference; copy before mutating
+	kQCBorrowed			// adopted from the caller, who may still be using it; copy before mutating
+};
+
+namespace Detail
+{
+	inline std::atomic<unsigned long long> &copyOnWriteCounter()
+	{
+		static std::atomic<unsigned long long> counter(0);
+		return counter;
+	}
+}
+
+// called by the wrappers whenever they copy an object in order to mutate it
+inline void noteCopyOnWrite()
+{
+	Detail::copyOnWriteCounter().fetch_add(1, std::memory_order_relaxed);
+}
+
+// number of copy-on-write copies made by all wrappers, on all threads, since launch or the last reset
+inline unsigned long long CopyOnWriteCount()
+{
+	return Detail::copyOnWriteCounter().load(std::memory_order_relaxed);
+}
+
+inline void ResetCopyOnWriteCount()
+{
+	Detail::copyOnWriteCounter().store(0, std::memory_order_relaxed);
+}
+
+namespace Detail
+{
+	// std::swap can't swap atomics; the wrappers only swap the states of objects no other thread is using
+	template < class T >
+	inline void swapRelaxed(std::atomic<T> &lhs, std::atomic<T> &rhs)
+	{
+		T const temp = lhs.load(std::memory_order_relaxed);
+		lhs.store(rhs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		rhs.store(temp, std::memory_order_relaxed);
+	}
+	
+	/* A shared reference whose other holders have all let go is ours alone again, so it needs no copy.
+	 * True if ref was kQCShared and we have now claimed it as kQCOwnedUnique.
+	 * A borrowed reference never qualifies: its caller may still use it without holding a retain.
+	 */
+	inline bool reclaimShared(std::atomic<QCOwnership> &ownership, CFTypeRef const ref)
+	{
+		if (ownership.load(std::memory_order_relaxed) != kQCShared || CFGetRetainCount(ref) != 1)
+		{
+			return false;
+		}
+		// whatever the last other holder did before its release happens before our writes
+		std::atomic_thread_fence(std::memory_order_acquire);
+		ownership.store(kQCOwnedUnique, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* The allocator a wrapper was constructed with, retained for as long as the wrapper lives.
+	 * It is only consulted when the wrapper has to create an object while it holds none;
+	 * copies of an object it does hold come from that object's own allocator.
+	 * NULL, the usual case, is kCFAllocatorDefault and costs no retain.
+	 */
+	class HeldAllocator
+	{
+	private:
+		CFAllocatorRef	allocator;
+
+	public:
+		explicit HeldAllocator(CFAllocatorRef const inAllocator = kCFAllocatorDefault)
+		: allocator( Retain(inAllocator) )
+		{ }
+
+		HeldAllocator(HeldAllocator const &rhs)
+		: allocator( Retain(rhs.allocator) )
+		{ }
+
+		HeldAllocator(HeldAllocator &&rhs) noexcept
+		: allocator( rhs.allocator )
+		{
+			rhs.allocator = kCFAllocatorDefault;
+		}
+
+		~HeldAllocator()
+		{
+			Release(allocator);
+		}
+
+		HeldAllocator & operator = (HeldAllocator rhs)
+		{
+			swap(rhs);
+			return *this;
+		}
+
+		void swap(HeldAllocator &rhs) noexcept
+		{
+			std::swap(allocator, rhs.allocator);
+		}
+
+		CFAllocatorRef get() const
+		{
+			return allocator;
+		}
+	};
+}
+
 void QCRelease(CFTypeRef object) DEPRECATED_DECLARATION("QCRelease is deprecated; use Release instead.");
 inline void QCRelease(CFTypeRef object)
 {
@@ -67,6 +182,41 @@ inline void QCRelease(CFTypeRef object)
 	return;
 }
 
+namespace Detail
+{
+	// CFEqual, but cheap hashes are compared first so that most unequal pairs never reach it
+	inline bool hashedEqual(CFTypeRef const lhs, CFHashCode const lhsHash, CFTypeRef const rhs, CFHashCode const rhsHash)
+	{
+		if (lhs == rhs) return true;
+		if (isNull(lhs) || isNull(rhs) || lhsHash != rhsHash) return false;
+		return CFEqual(lhs, rhs) == true;
+	}
+}
+
 END_QC_NAMESPACE
 
+/*
+ * std::hash and std::equal_to for a wrapper with a hash() member and a conversion to its CF type,
+ * so that it can key std::unordered_map and std::unordered_set.
+ * Use at global scope, after the wrapper's definition.
+ */
+#define QC_STD_HASH(Wrapper, CFRefType) \
+namespace std \
+{ \
+	template <> struct hash<QC::Wrapper> \
+	{ \
+		size_t operator () (QC::Wrapper const &value) const \
+		{ \
+			return static_cast<size_t>(value.hash()); \
+		} \
+	}; \
+	template <> struct equal_to<QC::Wrapper> \
+	{ \
+		bool operator () (QC::Wrapper const &lhs, QC::Wrapper const &rhs) const \
+		{ \
+			return QC::Detail::hashedEqual(static_cast<CFRefType>(lhs), lhs.hash(), static_cast<CFRefType>(rhs), rhs.hash()); \
+		} \
+	}; \
+}
+
 #endif
@@ -0,0 +1,240 @@
+/*
+ *  QCArenaAllocator.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCArenaAllocator.h"
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+BEGIN_QC_NAMESPACE
+
+namespace
+{
+	// precedes every block so that reallocate knows how much to copy;
+	// 16 bytes keeps the payload as aligned as malloc's
+	struct BlockHeader
+	{
+		CFIndex size;
+		CFIndex unused;
+	};
+	
+	CFIndex const kAlignment = 16;
+	
+	inline CFIndex roundUp(CFIndex const size)
+	{
+		return (size + kAlignment - 1) & ~(kAlignment - 1);
+	}
+	
+	inline BlockHeader *headerOf(void * const ptr)
+	{
+		return static_cast<BlockHeader *> (ptr) - 1;
+	}
+	
+	struct Arena
+	{
+		CFIndex				chunkSize;
+		std::vector<char *>	chunks;		// includes oversized blocks that got a chunk of their own
+		char				*cursor;	// next free byte in the current chunk
+		char				*limit;		// end of the current chunk
+		BlockHeader			*last;		// most recent block in the current chunk; can grow or shrink in place
+		CFIndex				reserved;
+		CFIndex				allocated;
+		// CF calls back from whichever thread creates, grows or releases an object
+		mutable std::mutex	lock;
+		
+		explicit Arena(CFIndex const inChunkSize)
+		: chunkSize( std::max(roundUp(inChunkSize), static_cast<CFIndex>(4096)) )
+		, chunks( )
+		, cursor( NULL )
+		, limit( NULL )
+		, last( NULL )
+		, reserved( 0 )
+		, allocated( 0 )
+		, lock( )
+		{ }
+		
+		~Arena()
+		{
+			for (std::vector<char *>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+			{
+				free(*it);
+			}
+		}
+		
+		char *newChunk(CFIndex const size)
+		{
+			char * const chunk = static_cast<char *> (malloc(size));
+			if (chunk != NULL)
+			{
+				chunks.push_back(chunk);
+				reserved += size;
+			}
+			return chunk;
+		}
+		
+		void *allocate(CFIndex const size)
+		{
+			CFIndex const need = sizeof(BlockHeader) + roundUp(size);
+			BlockHeader *block;
+			
+			if (need > chunkSize / 4)
+			{
+				// big enough to waste most of a chunk; give it its own
+				block = reinterpret_cast<BlockHeader *> (newChunk(need));
+				if (block == NULL) return NULL;
+			}
+			else
+			{
+				if (cursor == NULL || limit - cursor < need)
+				{
+					cursor = newChunk(chunkSize);
+					if (cursor == NULL) return NULL;
+					limit = cursor + chunkSize;
+				}
+				block = reinterpret_cast<BlockHeader *> (cursor);
+				cursor += need;
+				last = block;
+			}
+			
+			allocated += need;
+			block->size = size;
+			return block + 1;
+		}
+		
+		void *reallocate(void * const ptr, CFIndex const newSize)
+		{
+			BlockHeader * const block = headerOf(ptr);
+			CFIndex const oldSize = block->size;
+			
+			if (roundUp(newSize) <= roundUp(oldSize))
+			{
+				// shrinking, or growing into the alignment slack
+				block->size = newSize;
+				return ptr;
+			}
+			
+			if (block == last)
+			{
+				char * const end = reinterpret_cast<char *> (block + 1) + roundUp(newSize);
+				if (end <= limit)
+				{
+					allocated += end - cursor;
+					cursor = end;
+					block->size = newSize;
+					return ptr;
+				}
+			}
+			
+			void * const newPtr = allocate(newSize);
+			if (newPtr != NULL)
+			{
+				memcpy(newPtr, ptr, oldSize);
+			}
+			return newPtr;
+		}
+		
+		void deallocate(void * const ptr)
+		{
+			// blocks are only reclaimed with the whole arena, except for the most recent one
+			BlockHeader * const block = headerOf(ptr);
+			if (block == last)
+			{
+				char * const start = reinterpret_cast<char *> (block);
+				allocated -= cursor - start;
+				cursor = start;
+				last = NULL;
+			}
+		}
+	};
+	
+	// MARK: CFAllocatorContext callbacks
+	
+	void *arenaAllocate(CFIndex allocSize, CFOptionFlags /* hint */, void *info)
+	{
+		Arena * const arena = static_cast<Arena *> (info);
+		std::lock_guard<std::mutex> guard(arena->lock);
+		return arena->allocate(allocSize);
+	}
+	
+	void *arenaReallocate(void *ptr, CFIndex newSize, CFOptionFlags /* hint */, void *info)
+	{
+		Arena * const arena = static_cast<Arena *> (info);
+		std::lock_guard<std::mutex> guard(arena->lock);
+		return arena->reallocate(ptr, newSize);
+	}
+	
+	void arenaDeallocate(void *ptr, void *info)
+	{
+		Arena * const arena = static_cast<Arena *> (info);
+		std::lock_guard<std::mutex> guard(arena->lock);
+		arena->deallocate(ptr);
+	}
+	
+	CFIndex arenaPreferredSize(CFIndex size, CFOptionFlags /* hint */, void * /* info */)
+	{
+		// the alignment slack is free
+		return roundUp(size);
+	}
+	
+	// called by CF once the allocator itself is deallocated, i.e. nothing can use the arena any more
+	void arenaRelease(void const *info)
+	{
+		delete static_cast<Arena const *> (info);
+	}
+	
+	Arena const *arenaOf(CFAllocatorRef const allocator)
+	{
+		CFAllocatorContext context = {};
+		CFAllocatorGetContext(allocator, &context);
+		return static_cast<Arena const *> (context.info);
+	}
+}
+
+ArenaAllocator::ArenaAllocator(CFIndex const chunkSize)
+: allocator( NULL )
+{
+	Arena * const arena = new Arena(chunkSize);
+	
+	CFAllocatorContext context = {};
+	context.version = 0;
+	context.info = arena;
+	context.retain = NULL;		// CF holds the only pointer to info, so it needs no count of its own
+	context.release = arenaRelease;
+	context.copyDescription = NULL;
+	context.allocate = arenaAllocate;
+	context.reallocate = arenaReallocate;
+	context.deallocate = arenaDeallocate;
+	context.preferredSize = arenaPreferredSize;
+	
+	// the allocator object itself comes from the default allocator
+	allocator = CFAllocatorCreate(kCFAllocatorDefault, &context);
+	if (allocator == NULL)
+	{
+		delete arena;
+		throw std::bad_alloc();
+	}
+}
+
+CFIndex ArenaAllocator::bytesReserved() const
+{
+	Arena const * const arena = arenaOf(allocator);
+	std::lock_guard<std::mutex> guard(arena->lock);
+	return arena->reserved;
+}
+
+CFIndex ArenaAllocator::bytesAllocated() const
+{
+	Arena const * const arena = arenaOf(allocator);
+	std::lock_guard<std::mutex> guard(arena->lock);
+	return arena->allocated;
+}
+
+END_QC_NAMESPACE
@@ -0,0 +1,77 @@
+/*
+ *  QCArenaAllocator.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* A CFAllocator that bump-allocates from large chunks and never frees individual blocks.
+ * Every chunk is returned to the system at once, when the last object created with the arena
+ * (and the last ArenaAllocator referring to it) is released.
+ *
+ * Meant for building large, short-lived object trees such as parsed property lists.
+ * Every allocation, reallocation and release takes the arena's lock, so objects from the arena,
+ * and the copies the wrappers make of them to mutate, may be created and released on any thread.
+ */
+
+#ifndef _QC_ARENA_ALLOCATOR_GUARD_
+#define _QC_ARENA_ALLOCATOR_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <algorithm>
+#include "CFRaiiCommon.h"
+
+BEGIN_QC_NAMESPACE
+
+class ArenaAllocator
+{
+private:
+	CFAllocatorRef allocator;
+	
+public:
+	static CFIndex const kDefaultChunkSize = 1024 * 1024;
+	
+	// throws std::bad_alloc if the allocator cannot be created
+	explicit ArenaAllocator(CFIndex const chunkSize = kDefaultChunkSize);
+	
+	// copies share the same arena
+	ArenaAllocator(ArenaAllocator const &inArena)
+	: allocator( Retain(inArena.allocator) )
+	{ }
+	
+	~ArenaAllocator()
+	{
+		// the chunks outlive us if CF objects still refer to the allocator
+		Release(allocator);
+	}
+	
+	// copy assignment -- copy and swap
+	ArenaAllocator & operator = (ArenaAllocator const &rhs)
+	{
+		ArenaAllocator temp(rhs);
+		std::swap(allocator, temp.allocator);
+		return *this;
+	}
+	
+	// conversion operator, so an arena can be passed wherever a CFAllocatorRef is expected
+	operator CFAllocatorRef () const
+	{
+		return allocator;
+	}
+	
+	CFAllocatorRef Allocator() const
+	{
+		return allocator;
+	}
+	
+	// bytes obtained from the system so far
+	CFIndex bytesReserved() const;
+	// bytes handed out to CF so far, including per-block bookkeeping
+	CFIndex bytesAllocated() const;
+};
+
+END_QC_NAMESPACE
+
+#endif
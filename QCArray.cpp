@@ -29,7 +29,7 @@ bool QCArray1::writeToFile(QCString const &filePath, CFPropertyListFormat const
 	if (result)
 	{
 		// don't care about the error string
-		result = CFPropertyListWriteToStream(array, writeStream, format, NULL) != 0;
+		result = CFPropertyListWriteToStream(Array(), writeStream, format, NULL) != 0;
 		
 		CFWriteStreamClose(writeStream); // we're not ignoring anything -- it returns void
 	}
@@ -40,7 +40,7 @@ bool QCArray1::writeToFile(QCString const &filePath, CFPropertyListFormat const
 }
 
 // static method
-QCArray1 QCArray1::arrayFromFile(QCString const &filePath)
+QCArray1 QCArray1::arrayFromFile(QCString const &filePath, CFAllocatorRef const allocator)
 {
 	QCURL fileURL(filePath, false);
 	CFPropertyListRef plist(0);
@@ -52,10 +52,10 @@ QCArray1 QCArray1::arrayFromFile(QCString const &filePath)
 	{
 		// couldn't read file; return an empty array
 		CFRelease(readStream);
-		return QCArray1();
+		return QCArray1(allocator);
 	}
 	
-	plist = CFPropertyListCreateFromStream(kCFAllocatorDefault
+	plist = CFPropertyListCreateFromStream(allocator
 										   , readStream
 										   , 0 // full file
 										   , kCFPropertyListMutableContainersAndLeaves
@@ -70,10 +70,11 @@ QCArray1 QCArray1::arrayFromFile(QCString const &filePath)
 		|| CFGetTypeID(plist) != CFArrayGetTypeID())
 	{
 		Release(plist);
-		return QCArray1();
+		return QCArray1(allocator);
 	}
 	
-	return QCArray1(static_cast<CFArrayRef> ( plist ));
+	// we asked for mutable containers and nobody else has seen the result, so keep it mutable rather than copying it on first write
+	return QCArray1(static_cast<CFMutableArrayRef> ( const_cast<void *> ( plist ) ), kQCOwnedUnique, allocator);
 }
 
 END_QC_NAMESPACE
@@ -12,19 +12,77 @@
 
 #include <CoreFoundation/CoreFoundation.h>
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include "CFRaiiCommon.h"
-#include "QCSharedPtr.h"
+#include "QCRef.h"
 
 #include "QCString.h"
 #include "QCURL.h"
 
 BEGIN_QC_NAMESPACE
 
-class QCArray_shared_ptr : public QCSharedPtr < CFArrayRef >
+namespace Detail
+{
+	// MARK: comparators for CFArraySortValues and CFArrayBSearchValues
+	
+	// true when Compare declares its own CFComparatorFunction as a static compareValues
+	template < class Compare >
+	class HasCFComparator
+	{
+		template < class C >
+		static char test(decltype(static_cast<CFComparatorFunction>(&C::compareValues)) *);
+		template < class C >
+		static long test(...);
+		
+	public:
+		static bool const value = sizeof(test<Compare>(NULL)) == sizeof(char);
+	};
+	
+	// the trampoline: adapts a strict weak ordering on CFTypeRefs; context points at the ordering
+	template < class Compare >
+	CFComparisonResult compareThrough(void const *lhs, void const *rhs, void *context)
+	{
+		Compare &less = *static_cast<Compare *> (context);
+		if (less(lhs, rhs)) return kCFCompareLessThan;
+		if (less(rhs, lhs)) return kCFCompareGreaterThan;
+		return kCFCompareEqualTo;
+	}
+	
+	// chosen at compile time, so CF calls a comparator that has a compareValues directly
+	template < class Compare >
+	typename std::enable_if<HasCFComparator<Compare>::value, CFComparatorFunction>::type cfComparator()
+	{
+		return &Compare::compareValues;
+	}
+	
+	template < class Compare >
+	typename std::enable_if<!HasCFComparator<Compare>::value, CFComparatorFunction>::type cfComparator()
+	{
+		return &compareThrough<Compare>;
+	}
+}
+
+class QCArray_shared_ptr : public QCRef < CFArrayRef >
 {
 public:
+	QCArray_shared_ptr()
+	: QCRef < CFArrayRef > ( )
+	{ }
+	
+	explicit
+	QCArray_shared_ptr(CFArrayRef array)
+	: QCRef < CFArrayRef > ( array )
+	{ }
+	
+	// also accepts a QCRef < CFMutableArrayRef >
+	QCArray_shared_ptr(QCRef < CFArrayRef > const &ref)
+	: QCRef < CFArrayRef > ( ref )
+	{ }
+	
 	/* Just like with normal CoreFoundation functions,
 	 * it is the user's responsibility to ensure that the array is valid
 	 * before calling any of these methods.
@@ -58,12 +116,16 @@ public:
 	// no conversion operator to CFMutableArrayRef; it's a bad idea
 };
 
-class QCMutableArray_shared_ptr : public QCSharedPtr < CFMutableArrayRef >
+class QCMutableArray_shared_ptr : public QCRef < CFMutableArrayRef >
 {
 public:
+	QCMutableArray_shared_ptr()
+	: QCRef < CFMutableArrayRef > ( )
+	{ }
+	
 	explicit
 	QCMutableArray_shared_ptr(CFMutableArrayRef array)
-	: QCSharedPtr < CFMutableArrayRef > ( array )
+	: QCRef < CFMutableArrayRef > ( array )
 	{ }
 	
 	CFIndex GetCount() const
@@ -97,10 +159,81 @@ public:
 	}
 	
 	// conversion operator
-	operator QCArray_shared_ptr ()
+	operator QCArray_shared_ptr () const
 	{
 		// not a problem to add const to the opaque __CFArray *
-		return static_cast<QCArray_shared_ptr> (*this);
+		return QCArray_shared_ptr(QCRef < CFArrayRef > (*this));
+	}
+};
+
+/* A run of array elements fetched with a single CFArrayGetValues call, to use like a plain C array.
+ * The elements are not retained: the span is only good while the array it came from is alive and unchanged.
+ * Short runs are stored inside the object, longer ones on the heap.
+ */
+class QCArrayValues
+{
+public:
+	typedef CFTypeRef			value_type;
+	typedef CFTypeRef const *	const_iterator;
+	typedef const_iterator		iterator;
+	
+	static CFIndex const kInlineCapacity = 32;
+	
+private:
+	CFTypeRef				inlineValues[kInlineCapacity];
+	std::vector<CFTypeRef>	heapValues;
+	CFIndex					count;
+	
+public:
+	QCArrayValues()
+	: heapValues( )
+	, count( 0 )
+	{ }
+	
+	// the caller checks that range lies within the array
+	QCArrayValues(CFArrayRef const array, CFRange const range)
+	: heapValues( )
+	, count( range.length )
+	{
+		if (count > kInlineCapacity)
+		{
+			heapValues.resize(static_cast<size_t>(count));
+		}
+		if (count > 0)
+		{
+			CFArrayGetValues(array, range, const_cast<CFTypeRef *> (data()));
+		}
+	}
+	
+	// always computed, so that copies point into their own storage
+	CFTypeRef const *data() const
+	{
+		return (count > kInlineCapacity) ? &heapValues[0] : inlineValues;
+	}
+	
+	CFIndex size() const
+	{
+		return count;
+	}
+	
+	bool empty() const
+	{
+		return count == 0;
+	}
+	
+	const_iterator begin() const
+	{
+		return data();
+	}
+	
+	const_iterator end() const
+	{
+		return data() + count;
+	}
+	
+	CFTypeRef operator [] (CFIndex const idx) const
+	{
+		return data()[idx];
 	}
 };
 
@@ -110,29 +243,91 @@ class QCArray1
 private:
 	CFMutableArrayRef	mArray;
 	CFArrayRef			array;
+	// who else can see mArray; meaningless while mArray is NULL
+	mutable std::atomic<QCOwnership>	ownership;
+	// CFHash of the contents, once computed; kept only while they are immutable (see hash())
+	mutable std::atomic<CFHashCode>	hashCode;
+	// what an array is created from while we hold none
+	Detail::HeldAllocator	allocator;
+	
+	// adopt a mutable array whose ownership we already know, remembering the allocator it was asked for with
+	QCArray1(CFMutableArrayRef const &inArray, QCOwnership const inOwnership, CFAllocatorRef const inAllocator)
+	: mArray( inArray )
+	, array( NULL )
+	, ownership( inOwnership )
+	, hashCode( 0 )
+	, allocator( inAllocator )
+	{ }
+	
+	// another wrapper is about to hold our mutable array; neither of us may modify it in place any more
+	QCOwnership share() const
+	{
+		if (isNotNull(mArray))
+		{
+			// a borrowed reference stays borrowed, or reclaimShared could later hand the caller's object back to us
+			QCOwnership expected = kQCOwnedUnique;
+			ownership.compare_exchange_strong(expected, kQCShared, std::memory_order_relaxed);
+		}
+		return ownership.load(std::memory_order_relaxed);
+	}
 	
 public:
 	QCArray1( )
 	: array( NULL )
 	, mArray( CFArrayCreateMutable(kCFAllocatorDefault, 0, &kCFTypeArrayCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
+	// the array, any copies made to modify it, and any array created after this one is taken, come from inAllocator
+	explicit QCArray1(CFAllocatorRef const inAllocator)
+	: array( NULL )
+	, mArray( CFArrayCreateMutable(inAllocator, 0, &kCFTypeArrayCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( inAllocator )
+	{ }
+	
+	// takes ownership, but the caller may still be holding on to inArray, so the first mutation copies it
 	explicit QCArray1(CFMutableArrayRef const &inArray)
 	: array( NULL )
 	, mArray( inArray )
+	, ownership( kQCBorrowed )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
 	explicit QCArray1(CFArrayRef const &inArray)
 	: array( inArray )
 	, mArray( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
 	// copy constructor
 	QCArray1(QCArray1 const &inArray)
 	: array( Retain(inArray.array) )
 	, mArray( Retain(inArray.mArray) )
+	, ownership( inArray.share() )
+	, hashCode( inArray.hashCode.load(std::memory_order_relaxed) )
+	, allocator( inArray.allocator )
 	{ }
 	
+	// move constructor -- steals inArray's references; inArray is left null
+	QCArray1(QCArray1 &&inArray) noexcept
+	: array( inArray.array )
+	, mArray( inArray.mArray )
+	, ownership( inArray.ownership.load(std::memory_order_relaxed) )
+	, hashCode( inArray.hashCode.load(std::memory_order_relaxed) )
+	, allocator( std::move(inArray.allocator) )
+	{
+		inArray.array = NULL;
+		inArray.mArray = NULL;
+		inArray.hashCode.store(0, std::memory_order_relaxed);
+	}
+	
 	// destructor
 	~QCArray1( )
 	{
@@ -154,6 +349,8 @@ public:
 	// MARK: Helper Classes
 	
 	// MARK: class CFTypeProxy
+	// Proxies and iterators borrow the array: they neither retain nor release it,
+	// so like any container's iterators they are only good while the QCArray1 holds that array.
 	class CFTypeProxy
 	{
 	private:
@@ -166,20 +363,9 @@ public:
 	public:
 		// ctor
 		CFTypeProxy(CFArrayRef const arrayRef, CFIndex const idx)
-		: array(Retain(arrayRef)), index(idx)
+		: array(arrayRef), index(idx)
 		{ }
 		
-		// copy ctor
-		CFTypeProxy(CFTypeProxy const &proxy)
-		: array(Retain(proxy.array)), index(proxy.index)
-		{ }
-		
-		// dtor
-		~CFTypeProxy()
-		{
-			Release(array);
-		}
-		
 		// comparison operators
 		bool operator == (CFTypeProxy const &rhs) const
 		{
@@ -200,41 +386,31 @@ public:
 	}; // class CFTypeProxy
 	
 	// MARK: class const_iterator
+	// a random-access iterator that reads elements straight out as CFTypeRefs
 	class const_iterator
 	{
+	public:
+		typedef std::random_access_iterator_tag	iterator_category;
+		typedef CFTypeRef						value_type;
+		typedef CFIndex							difference_type;
+		typedef CFTypeRef const *				pointer;
+		typedef CFTypeRef						reference; // elements are returned by value
+		
 	private:
 		// data members
 		CFArrayRef		array;
 		CFIndex			currentIndex;
 		
 	public:
-		// ctor
-		const_iterator(CFArrayRef const arrayRef, CFIndex const idx)
-		: array(Retain(array)), currentIndex(idx)
+		const_iterator()
+		: array(NULL), currentIndex(0)
 		{ }
 		
-		// copy ctor
-		const_iterator(const_iterator const &iter)
-		: array(Retain(iter.array)), currentIndex(iter.currentIndex)
+		// ctor
+		const_iterator(CFArrayRef const arrayRef, CFIndex const idx)
+		: array(arrayRef), currentIndex(idx)
 		{ }
 		
-		// dtor
-		~const_iterator()
-		{
-			Release(array);
-		}
-		
-		// copy-assignment
-		const_iterator & operator = (const_iterator const &rhs)
-		{
-			Release(array);
-			
-			array = Retain(rhs.array);
-			currentIndex = rhs.currentIndex;
-			
-			return *this;
-		}
-		
 		// prefix operators (must return by reference)
 		const_iterator & operator ++ ()
 		{
@@ -263,6 +439,39 @@ public:
 			return temp;
 		}
 		
+		// arithmetic
+		const_iterator & operator += (CFIndex const arg)
+		{
+			currentIndex += arg;
+			return *this;
+		}
+		
+		const_iterator & operator -= (CFIndex const arg)
+		{
+			currentIndex -= arg;
+			return *this;
+		}
+		
+		const_iterator operator + (CFIndex const arg) const
+		{
+			return const_iterator(array, currentIndex + arg);
+		}
+		
+		const_iterator operator - (CFIndex const arg) const
+		{
+			return const_iterator(array, currentIndex - arg);
+		}
+		
+		CFIndex operator - (const_iterator const &rhs) const
+		{
+			return currentIndex - rhs.currentIndex;
+		}
+		
+		friend const_iterator operator + (CFIndex const arg, const_iterator const &rhs)
+		{
+			return rhs + arg;
+		}
+		
 		// comparison operators
 		bool operator == (const_iterator const &rhs) const
 		{
@@ -272,12 +481,22 @@ public:
 		bool operator != (const_iterator const &rhs) const
 		{
 			return !(*this == rhs);
-		}		
+		}
 		
-		// dereference operator
-		CFTypeProxy const operator * () const
+		bool operator < (const_iterator const &rhs) const	{ return currentIndex < rhs.currentIndex; }
+		bool operator > (const_iterator const &rhs) const	{ return currentIndex > rhs.currentIndex; }
+		bool operator <= (const_iterator const &rhs) const	{ return currentIndex <= rhs.currentIndex; }
+		bool operator >= (const_iterator const &rhs) const	{ return currentIndex >= rhs.currentIndex; }
+		
+		// dereference operators
+		CFTypeRef operator * () const
 		{
-			return CFTypeProxy(array, currentIndex);
+			return CFArrayGetValueAtIndex(array, currentIndex);
+		}
+		
+		CFTypeRef operator [] (CFIndex const arg) const
+		{
+			return CFArrayGetValueAtIndex(array, currentIndex + arg);
 		}
 	}; // class const_iterator
 	
@@ -295,20 +514,9 @@ public:
 	public:
 		// ctor
 		CFMutableTypeProxy(CFMutableArrayRef const arrayRef, CFIndex const idx)
-		: array(Retain(arrayRef)), index(idx)
+		: array(arrayRef), index(idx)
 		{ }
 		
-		// copy ctor
-		CFMutableTypeProxy(CFMutableTypeProxy const &proxy)
-		: array(Retain(proxy.array)), index(proxy.index)
-		{ }
-		
-		// dtor
-		~CFMutableTypeProxy()
-		{
-			Release(array);
-		}
-		
 		// conversion operators
 		operator CFTypeRef () const
 		{
@@ -330,41 +538,31 @@ public:
 	}; // class CFMutableTypeProxy
 	
 	// MARK: class iterator
+	// as const_iterator, but dereferences to a proxy that can also be assigned to
 	class iterator
 	{
+	public:
+		typedef std::random_access_iterator_tag	iterator_category;
+		typedef CFTypeRef						value_type;
+		typedef CFIndex							difference_type;
+		typedef CFTypeRef const *				pointer;
+		typedef CFMutableTypeProxy				reference;
+		
 	private:
 		// data members
 		CFMutableArrayRef	array;
 		CFIndex				currentIndex;
 		
 	public:
-		// ctor
-		iterator(CFMutableArrayRef const arrayRef, CFIndex const idx)
-		: array(Retain(arrayRef)), currentIndex(idx)
+		iterator()
+		: array(NULL), currentIndex(0)
 		{ }
 		
-		// copy ctor
-		iterator(iterator const &iter)
-		: array(Retain(iter.array)), currentIndex(iter.currentIndex)
+		// ctor
+		iterator(CFMutableArrayRef const arrayRef, CFIndex const idx)
+		: array(arrayRef), currentIndex(idx)
 		{ }
 		
-		// dtor
-		~iterator()
-		{
-			Release(array);
-		}
-		
-		// copy-assignment
-		iterator & operator = (iterator const &rhs)
-		{
-			Release(array);
-			
-			array = Retain(rhs.array);
-			currentIndex = rhs.currentIndex;
-			
-			return *this;
-		}
-		
 		// prefix operators (must return by reference)
 		iterator & operator ++ ()
 		{
@@ -404,35 +602,52 @@ public:
 			return !(*this == rhs);
 		}
 		
+		bool operator < (iterator const &rhs) const		{ return currentIndex < rhs.currentIndex; }
+		bool operator > (iterator const &rhs) const		{ return currentIndex > rhs.currentIndex; }
+		bool operator <= (iterator const &rhs) const	{ return currentIndex <= rhs.currentIndex; }
+		bool operator >= (iterator const &rhs) const	{ return currentIndex >= rhs.currentIndex; }
+		
 		// dereference operator
 		CFMutableTypeProxy operator * () const
 		{
 			return CFMutableTypeProxy(array, currentIndex);
 		}
 		
-		/* // doesn't apply
-		 CFMutableTypeProxy operator -> () const
-		 {
-		 return CFMutableTypeProxy(array, currentIndex);
-		 }
-		 */
-		
 		iterator & operator += (CFIndex const arg)
 		{
 			currentIndex += arg;
 			return *this;
 		}
 		
-		iterator operator + (CFIndex const arg)
+		iterator & operator -= (CFIndex const arg)
+		{
+			currentIndex -= arg;
+			return *this;
+		}
+		
+		iterator operator + (CFIndex const arg) const
 		{
 			return iterator(array, currentIndex + arg);
-			iterator temp(*this);
-			return temp += arg;
+		}
+		
+		iterator operator - (CFIndex const arg) const
+		{
+			return iterator(array, currentIndex - arg);
+		}
+		
+		CFIndex operator - (iterator const &rhs) const
+		{
+			return currentIndex - rhs.currentIndex;
+		}
+		
+		friend iterator operator + (CFIndex const arg, iterator const &rhs)
+		{
+			return rhs + arg;
 		}
 		
 		// operator [] must be a non-static member function
 		// and we use operator + in it, so we made operator + a member function rather than a free one
-		CFMutableTypeProxy operator [] (CFIndex const arg)
+		CFMutableTypeProxy operator [] (CFIndex const arg) const
 		{
 			return * (this -> operator + (arg));
 		}
@@ -452,39 +667,35 @@ public:
 		{
 			if (array != NULL)
 			{
-				mArray = CFArrayCreateMutableCopy(kCFAllocatorDefault
+				mArray = CFArrayCreateMutableCopy(CFGetAllocator(array)
 												  , 0
 												  , array);
 				CFRelease(array);
 				array = NULL;
+				noteCopyOnWrite();
 			}
 			else
 			{
-				mArray = CFArrayCreateMutable(kCFAllocatorDefault
+				mArray = CFArrayCreateMutable(allocator.get()
 											  , 0
 											  , &kCFTypeArrayCallBacks);
 			}
-			
+			ownership = kQCOwnedUnique;
 		}
 	}
 	
 	void makeUnique()
 	{
 		// don't care if 'array' is shared, just 'mArray'
-		if (!isNull(mArray) && CFGetRetainCount(mArray) > 1)
+		// (a retain count above 1 proves nothing, since CF and other non-wrapper code retain without sharing;
+		// a count of 1 does prove the other wrappers have let go -- see reclaimShared)
+		if (!isNull(mArray) && ownership != kQCOwnedUnique && !Detail::reclaimShared(ownership, mArray))
 		{
-			CFMutableArrayRef newArray = CFArrayCreateMutableCopy(kCFAllocatorDefault, 0, mArray);
+			CFMutableArrayRef newArray = CFArrayCreateMutableCopy(CFGetAllocator(mArray), 0, mArray);
 			CFRelease(mArray);
 			mArray = newArray;
-		}
-		return;
-		
-		if (! null() && CFGetRetainCount(Array()) > 1)
-		{
-			CFMutableArrayRef newArray = CFArrayCreateMutableCopy(kCFAllocatorDefault, 0, Array());
-			Release(Array());
-			array = NULL;
-			mArray = newArray;
+			ownership = kQCOwnedUnique;
+			noteCopyOnWrite();
 		}
 	}
 	
@@ -493,6 +704,20 @@ public:
 		return isNull( Array() );
 	}
 	
+	// CFHash of the contents; memoized while they are immutable, recomputed while they may still change
+	// (as they may in anything holding a mutable reference, which includes whatever arrayFromFile returns)
+	CFHashCode hash() const
+	{
+		// relaxed is enough: any thread that computes the hash computes the same value
+		CFHashCode const cached = hashCode.load(std::memory_order_relaxed);
+		if (cached != 0 && isNull(mArray)) return cached;
+		
+		CFTypeRef const ref = Array();
+		CFHashCode const h = isNull(ref) ? 0 : CFHash(ref);
+		if (isNull(mArray)) hashCode.store(h, std::memory_order_relaxed);
+		return h;
+	}
+	
 	CFIndex GetCount() const
 	{
 		return null() ? 0 : CFArrayGetCount(Array());
@@ -509,6 +734,16 @@ public:
 		return QCArray1(*this);// null() ? QCArray1() : QCArray1(CFArrayCreateMutableCopy(kCFAllocatorDefault, 0, array));
 	}
 	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this array null
+	CFArrayRef take() &&
+	{
+		CFArrayRef const arr = Array();
+		mArray = NULL;
+		array = NULL;
+		hashCode.store(0, std::memory_order_relaxed);
+		return arr;
+	}
+	
 	// Operators
 	
 	// copy assignment
@@ -517,10 +752,24 @@ public:
 		QCArray1 temp(rhs);
 		std::swap(array, temp.array);
 		std::swap(mArray, temp.mArray);
+		Detail::swapRelaxed(ownership, temp.ownership);
+		Detail::swapRelaxed(hashCode, temp.hashCode);
+		allocator.swap(temp.allocator);
 		return *this;
 		
 	}
 	
+	// move assignment
+	QCArray1 & operator = (QCArray1 &&rhs) noexcept
+	{
+		std::swap(array, rhs.array);
+		std::swap(mArray, rhs.mArray);
+		Detail::swapRelaxed(ownership, rhs.ownership);
+		Detail::swapRelaxed(hashCode, rhs.hashCode);
+		allocator.swap(rhs.allocator);
+		return *this;
+	}
+	
 	// comparison operators
 	bool operator == (QCArray1 const &rhs) const
 	{
@@ -536,8 +785,8 @@ public:
 	// compound assignment -- concatenation
 	QCArray1 & operator += (QCArray1 const &rhs)
 	{
-		// if rhs.array == NULL do nothing
-		if (rhs.array != NULL)
+		// if rhs is null do nothing
+		if (!rhs.null())
 		{
 			makeMutable();
 			makeUnique();
@@ -599,11 +848,6 @@ public:
 		{
 			makeMutable();
 			makeUnique();
-			if (null())
-			{
-				// create array if there isn't one yet
-				mArray = CFArrayCreateMutable(kCFAllocatorDefault, 0, &kCFTypeArrayCallBacks);
-			}
 			CFArrayAppendValue(mArray, value);
 		}
 	}
@@ -634,11 +878,26 @@ public:
 		}
 	}
 	
+	// replaces the values in range with count new ones, all in one call
+	// throws out_of_range exception for a range that is not within the array
+	void ReplaceValues(CFRange const range, CFTypeRef const *values, CFIndex const count)
+	{
+		if (range.location < 0 || range.length < 0 || range.location + range.length > GetCount())
+		{
+			throw std::out_of_range(std::string("Replacing values for invalid range."));
+		}
+		makeMutable();
+		makeUnique();
+		// CF retains the new values before releasing the old, so elements we hold only through the array survive
+		CFArrayReplaceValues(mArray, range, const_cast<CFTypeRef *> (values), count);
+	}
+	
 	void show() const;
 	
 	bool writeToFile(QCString const &filePath, CFPropertyListFormat const format) const;
 	
-	static QCArray1 arrayFromFile(QCString const &filePath);
+	// pass an ArenaAllocator (QCArenaAllocator.h) to parse a large file without a malloc per object
+	static QCArray1 arrayFromFile(QCString const &filePath, CFAllocatorRef const allocator = kCFAllocatorDefault);
 	
 	const_iterator begin() const
 	{
@@ -673,11 +932,128 @@ public:
 	{
 		return CFArrayGetValueAtIndex(Array(), idx);
 	}
+	
+	// MARK: Sorting and searching
+	
+	/* comp is a strict weak ordering called with two CFTypeRefs, like std::sort's,
+	 * or a comparator with a static CFComparatorFunction compareValues
+	 * (QCStringOrdinalLess, QCNumberLess), which CF then calls without the trampoline.
+	 * comp must not throw: it is called from inside CF.
+	 */
+	
+	// sorts in place with CFArraySortValues; elements that compare equal may be reordered
+	template < class Compare >
+	void sort(Compare comp)
+	{
+		CFIndex const count = GetCount();
+		if (count < 2)
+		{
+			return;
+		}
+		
+		makeMutable();
+		makeUnique();
+		CFArraySortValues(mArray, CFRangeMake(0, count), Detail::cfComparator<Compare>(), &comp);
+	}
+	
+	// Like sort, but keeps elements that compare equal in their original order.
+	// CF makes no stability promise, so this sorts a buffer of the element pointers
+	// and writes them back with one ReplaceValues; the elements themselves are never copied.
+	template < class Compare >
+	void stable_sort(Compare comp)
+	{
+		CFIndex const count = GetCount();
+		if (count < 2)
+		{
+			return;
+		}
+		
+		std::vector<CFTypeRef> sorted(static_cast<size_t>(count));
+		CFArrayGetValues(Array(), CFRangeMake(0, count), &sorted[0]);
+		
+		CFComparatorFunction const compare = Detail::cfComparator<Compare>();
+		std::stable_sort(sorted.begin(), sorted.end(), [&](CFTypeRef const lhs, CFTypeRef const rhs)
+		{
+			return compare(lhs, rhs, &comp) == kCFCompareLessThan;
+		});
+		
+		ReplaceValues(CFRangeMake(0, count), &sorted[0], count);
+	}
+	
+	// For an array sorted by comp: where value would be inserted to keep it sorted,
+	// or the index of an element equal to it (any one of them, if there are several).
+	template < class Compare >
+	CFIndex insertionIndex(CFTypeRef const value, Compare comp) const
+	{
+		CFIndex const count = GetCount();
+		if (count == 0)
+		{
+			return 0;
+		}
+		
+		CFIndex const idx = CFArrayBSearchValues(Array(), CFRangeMake(0, count), value, Detail::cfComparator<Compare>(), &comp);
+		return std::min(idx, count);
+	}
+	
+	// for an array sorted by comp: the index of an element equal to value, or kCFNotFound
+	template < class Compare >
+	CFIndex binarySearch(CFTypeRef const value, Compare comp) const
+	{
+		CFIndex const idx = insertionIndex(value, comp);
+		if (idx < GetCount()
+			&& Detail::cfComparator<Compare>()(value, CFArrayGetValueAtIndex(Array(), idx), &comp) == kCFCompareEqualTo)
+		{
+			return idx;
+		}
+		return kCFNotFound;
+	}
+	
+	// MARK: Bulk access
+	
+	// throws out_of_range exception for a range that is not within the array
+	QCArrayValues values(CFRange const range) const
+	{
+		if (range.location < 0 || range.length < 0 || range.location + range.length > GetCount())
+		{
+			throw std::out_of_range(std::string("Getting values for invalid range."));
+		}
+		return QCArrayValues(Array(), range);
+	}
+	
+	QCArrayValues values() const
+	{
+		return QCArrayValues(Array(), CFRangeMake(0, GetCount()));
+	}
+	
+	// Calls f(CFTypeRef const *values, CFIndex count) on consecutive blocks of the whole array, in order.
+	// The block is a stack buffer sized to stay in L1 cache, so scanning a huge array allocates nothing
+	// and makes one CF call per block instead of one per element.
+	template < class F >
+	void forEachChunk(F f) const
+	{
+		CFArrayRef const arrayRef = Array();
+		CFIndex const count = GetCount();
+		CFTypeRef chunk[512];
+		CFIndex const chunkSize = sizeof(chunk) / sizeof(chunk[0]);
+		
+		for (CFIndex start = 0; start < count; start += chunkSize)
+		{
+			CFIndex const length = std::min(chunkSize, count - start);
+			CFArrayGetValues(arrayRef, CFRangeMake(start, length), chunk);
+			f(static_cast<CFTypeRef const *> (chunk), length);
+		}
+	}
 };
 
 typedef QCArray1	QCArray;
 
+// iterators are passed around by value as freely as pointers
+static_assert(std::is_trivially_copyable<QCArray1::const_iterator>::value, "QCArray1::const_iterator must stay trivially copyable");
+static_assert(std::is_trivially_copyable<QCArray1::iterator>::value, "QCArray1::iterator must stay trivially copyable");
+
 
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCArray1, CFArrayRef)
+
 #endif
@@ -16,7 +16,7 @@ BEGIN_QC_NAMESPACE
 void QCData::show() const
 {
 #ifndef NDEBUG
-	CFShow(data);
+	CFShow(Data());
 #endif
 }
 
@@ -39,25 +39,25 @@ bool QCData::writeToFile(CFStringRef const filePath) const
 }
 
 // static method
-QCData QCData::dataFromFile(CFStringRef const filePath)
+QCData QCData::dataFromFile(CFStringRef const filePath, CFAllocatorRef const allocator)
 {
 	QCURL fileURL(filePath, false);
-	return dataFromFile(fileURL);
+	return dataFromFile(fileURL, allocator);
 }
 
 // static method
-QCData QCData::dataFromFile(CFURLRef const fileURL)
+QCData QCData::dataFromFile(CFURLRef const fileURL, CFAllocatorRef const allocator)
 {
 	CFReadStreamRef readStream = CFReadStreamCreateWithFile(kCFAllocatorDefault, fileURL);
 	if (CFReadStreamOpen(readStream) == 0) // treat Boolean
 	{
 		// couldn't read file; return empty data
 		CFRelease(readStream);
-		return QCData();
+		return QCData(allocator);
 	}
 	UInt8 bytes[kBufferSize];
 	
-	QCData fileData;
+	QCData fileData(allocator);
 	CFIndex bytesRead(0);
 	while ( (bytesRead = CFReadStreamRead(readStream, bytes, kBufferSize)) > 0 )
 	{
@@ -11,7 +11,7 @@
 #define _QC_DATA_GUARD_
 
 #include <CoreFoundation/CoreFoundation.h>
-//#include <algorithm>
+#include <algorithm>
 #include "CFRaiiCommon.h"
 
 #include "QCString.h"
@@ -25,15 +25,33 @@ class QCData
 private:
 	CFMutableDataRef	mData;
 	CFDataRef			data;
+	// who else can see mData; meaningless while mData is NULL
+	mutable std::atomic<QCOwnership>	ownership;
+	// CFHash of the contents, once computed; kept only while they are immutable (see hash())
+	mutable std::atomic<CFHashCode>	hashCode;
+	// what data is created from while we hold none
+	Detail::HeldAllocator	allocator;
+	
+	// another wrapper is about to hold our mutable data; neither of us may modify it in place any more
+	QCOwnership share() const
+	{
+		if (isNotNull(mData))
+		{
+			// a borrowed reference stays borrowed, or reclaimShared could later hand the caller's object back to us
+			QCOwnership expected = kQCOwnedUnique;
+			ownership.compare_exchange_strong(expected, kQCShared, std::memory_order_relaxed);
+		}
+		return ownership.load(std::memory_order_relaxed);
+	}
 	
 	CFMutableDataRef CFMutableDataFromCFData(CFDataRef const inData) const
 	{
-		return (inData == NULL) ? NULL : CFDataCreateMutableCopy(kCFAllocatorDefault, 0, inData);
+		return (inData == NULL) ? NULL : CFDataCreateMutableCopy(CFGetAllocator(inData), 0, inData);
 #if 0
 		CFMutableDataRef temp(0);
 		if (inData != 0)
 		{
-			temp = CFDataCreateMutableCopy(kCFAllocatorDefault, 0, inData);
+			temp = CFDataCreateMutableCopy(CFGetAllocator(inData), 0, inData);
 		}
 		return temp;
 #endif
@@ -43,16 +61,35 @@ public:
 	QCData()
 	: data( NULL )
 	, mData( CFDataCreateMutable(kCFAllocatorDefault, 0) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
+	{ }
+	
+	// the data, any copies made to modify it, and any data created after this is taken, come from inAllocator
+	explicit QCData(CFAllocatorRef const inAllocator)
+	: data( NULL )
+	, mData( CFDataCreateMutable(inAllocator, 0) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( inAllocator )
 	{ }
 	
+	// takes ownership, but the caller may still be holding on to inData, so the first mutation copies it
 	explicit QCData(CFMutableDataRef const &inData )
 	: data( NULL )
 	, mData( inData )
+	, ownership( kQCBorrowed )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
 	explicit QCData(CFDataRef const &inData)
 	: data( inData )
 	, mData( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
 	{
 		Release(inData);
 	}
@@ -61,8 +98,24 @@ public:
 	QCData(QCData const &inData)
 	: data( Retain(inData.data) )
 	, mData( Retain(inData.mData) )
+	, ownership( inData.share() )
+	, hashCode( inData.hashCode.load(std::memory_order_relaxed) )
+	, allocator( inData.allocator )
 	{ }
 	
+	// move constructor -- steals inData's references; inData is left null
+	QCData(QCData &&inData) noexcept
+	: data( inData.data )
+	, mData( inData.mData )
+	, ownership( inData.ownership.load(std::memory_order_relaxed) )
+	, hashCode( inData.hashCode.load(std::memory_order_relaxed) )
+	, allocator( std::move(inData.allocator) )
+	{
+		inData.data = NULL;
+		inData.mData = NULL;
+		inData.hashCode.store(0, std::memory_order_relaxed);
+	}
+	
 	// destructor
 	~QCData()
 	{
@@ -90,32 +143,26 @@ public:
 				mData = CFMutableDataFromCFData(data);
 				CFRelease(data);
 				data = NULL;
+				noteCopyOnWrite();
 			}
 			else {
-				mData = CFDataCreateMutable(kCFAllocatorDefault, 0);
+				mData = CFDataCreateMutable(allocator.get(), 0);
 			}
-			
+			ownership = kQCOwnedUnique;
 		}
 	}
 	
 	// should be atomic
 	void makeUnique()
 	{
-		if (!isNull(mData) && CFGetRetainCount(mData) > 1)
+		if (!isNull(mData) && ownership != kQCOwnedUnique && !Detail::reclaimShared(ownership, mData))
 		{
 			// someone else owns it now
-			CFMutableDataRef newData = CFDataCreateMutableCopy(kCFAllocatorDefault, 0, mData);
+			CFMutableDataRef newData = CFDataCreateMutableCopy(CFGetAllocator(mData), 0, mData);
 			CFRelease(mData);
 			mData = newData;
-		}
-		return;
-		
-		if (! null() && CFGetRetainCount(Data()) > 1)
-		{
-			CFMutableDataRef newData = CFDataCreateMutableCopy(kCFAllocatorDefault, 0, Data());
-			Release(Data());
-			data = NULL;
-			mData = newData;
+			ownership = kQCOwnedUnique;
+			noteCopyOnWrite();
 		}
 	}
 	
@@ -124,6 +171,19 @@ public:
 		return isNull(Data());
 	}
 	
+	// CFHash of the contents; memoized while they are immutable, recomputed while they may still change
+	CFHashCode hash() const
+	{
+		// relaxed is enough: any thread that computes the hash computes the same value
+		CFHashCode const cached = hashCode.load(std::memory_order_relaxed);
+		if (cached != 0 && isNull(mData)) return cached;
+		
+		CFTypeRef const ref = Data();
+		CFHashCode const h = isNull(ref) ? 0 : CFHash(ref);
+		if (isNull(mData)) hashCode.store(h, std::memory_order_relaxed);
+		return h;
+	}
+	
 	CFIndex length () const
 	{
 		return CFDataGetLength(Data());
@@ -134,6 +194,16 @@ public:
 		return QCData(*this);//null() ? QCData() : QCData(CFDataCreateMutableCopy(kCFAllocatorDefault, 0, data));
 	}
 	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this data null
+	CFDataRef take() &&
+	{
+		CFDataRef const d = Data();
+		mData = NULL;
+		data = NULL;
+		hashCode.store(0, std::memory_order_relaxed);
+		return d;
+	}
+	
 	void GetBytes(UInt8 *buffer) const
 	{
 		if (!null())
@@ -156,6 +226,20 @@ public:
 		QCData temp(rhs);
 		std::swap(data, temp.data);
 		std::swap(mData, temp.mData);
+		Detail::swapRelaxed(ownership, temp.ownership);
+		Detail::swapRelaxed(hashCode, temp.hashCode);
+		allocator.swap(temp.allocator);
+		return *this;
+	}
+	
+	// move assignment
+	QCData & operator = (QCData &&rhs) noexcept
+	{
+		std::swap(data, rhs.data);
+		std::swap(mData, rhs.mData);
+		Detail::swapRelaxed(ownership, rhs.ownership);
+		Detail::swapRelaxed(hashCode, rhs.hashCode);
+		allocator.swap(rhs.allocator);
 		return *this;
 	}
 	
@@ -188,12 +272,14 @@ public:
 	
 	bool writeToFile(CFStringRef const filePath) const;
 	
-	static QCData dataFromFile(CFURLRef const fileURL);
-	static QCData dataFromFile(CFStringRef const filePath);
+	static QCData dataFromFile(CFURLRef const fileURL, CFAllocatorRef const allocator = kCFAllocatorDefault);
+	static QCData dataFromFile(CFStringRef const filePath, CFAllocatorRef const allocator = kCFAllocatorDefault);
 };
 
 typedef QCData const QCFixedData;
 
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCData, CFDataRef)
+
 #endif
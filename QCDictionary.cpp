@@ -16,7 +16,7 @@ BEGIN_QC_NAMESPACE
 void QCDictionary::show() const
 {
 #ifndef NDEBUG
-	CFShow(dict);
+	CFShow(Dictionary());
 #endif
 }
 
@@ -29,7 +29,7 @@ bool QCDictionary::writeToFile(QCString const &filePath, CFPropertyListFormat co
 	if (result)
 	{
 		// don't care about the error string
-		result = CFPropertyListWriteToStream(dict, writeStream, format, 0) != 0;
+		result = CFPropertyListWriteToStream(Dictionary(), writeStream, format, 0) != 0;
 		
 		CFWriteStreamClose(writeStream);
 	}
@@ -40,7 +40,7 @@ bool QCDictionary::writeToFile(QCString const &filePath, CFPropertyListFormat co
 }
 
 // static
-QCDictionary QCDictionary::dictionaryFromFile(QCString const &filePath, CFPropertyListFormat &plistFormat)
+QCDictionary QCDictionary::dictionaryFromFile(QCString const &filePath, CFPropertyListFormat &plistFormat, CFAllocatorRef const allocator)
 {
 	QCURL fileURL(filePath, false);
 	CFPropertyListRef plist(0);
@@ -51,10 +51,10 @@ QCDictionary QCDictionary::dictionaryFromFile(QCString const &filePath, CFProper
 	{
 		// couldn't read file; return an empty dictionary
 		CFRelease(readStream);
-		return QCDictionary();
+		return QCDictionary(allocator);
 	}
 	
-	plist = CFPropertyListCreateFromStream(kCFAllocatorDefault
+	plist = CFPropertyListCreateFromStream(allocator
 										   , readStream
 										   , 0 // full file
 										   , kCFPropertyListMutableContainersAndLeaves
@@ -69,10 +69,11 @@ QCDictionary QCDictionary::dictionaryFromFile(QCString const &filePath, CFProper
 		|| CFGetTypeID(plist) != CFDictionaryGetTypeID())
 	{
 		Release(plist);
-		return QCDictionary();
+		return QCDictionary(allocator);
 	}
 	
-	return QCDictionary(static_cast<CFDictionaryRef> ( plist ));
+	// we asked for mutable containers and nobody else has seen the result, so keep it mutable rather than copying it on first write
+	return QCDictionary(static_cast<CFMutableDictionaryRef> ( const_cast<void *> ( plist ) ), kQCOwnedUnique, allocator);
 }
 
 END_QC_NAMESPACE
@@ -23,15 +23,42 @@ class QCDictionary
 {
 	CFMutableDictionaryRef	mDict;
 	CFDictionaryRef			dict;
+	// who else can see mDict; meaningless while mDict is NULL
+	mutable std::atomic<QCOwnership>	ownership;
+	// CFHash of the contents, once computed; kept only while they are immutable (see hash())
+	mutable std::atomic<CFHashCode>		hashCode;
+	// what a dictionary is created from while we hold none
+	Detail::HeldAllocator	allocator;
+	
+	// adopt a mutable dictionary whose ownership we already know, remembering the allocator it was asked for with
+	QCDictionary(CFMutableDictionaryRef const &inDict, QCOwnership const inOwnership, CFAllocatorRef const inAllocator)
+	: mDict( inDict )
+	, dict( NULL )
+	, ownership( inOwnership )
+	, hashCode( 0 )
+	, allocator( inAllocator )
+	{ }
+	
+	// another wrapper is about to hold our mutable dictionary; neither of us may modify it in place any more
+	QCOwnership share() const
+	{
+		if (isNotNull(mDict))
+		{
+			// a borrowed reference stays borrowed, or reclaimShared could later hand the caller's object back to us
+			QCOwnership expected = kQCOwnedUnique;
+			ownership.compare_exchange_strong(expected, kQCShared, std::memory_order_relaxed);
+		}
+		return ownership.load(std::memory_order_relaxed);
+	}
 	
 	CFMutableDictionaryRef CFMutableDictionaryFromCFDictionary(CFDictionaryRef const inDict) const
 	{
-		return (inDict == NULL) ? NULL : CFDictionaryCreateMutableCopy(kCFAllocatorDefault, 0, inDict);
+		return (inDict == NULL) ? NULL : CFDictionaryCreateMutableCopy(CFGetAllocator(inDict), 0, inDict);
 #if 0
 		CFMutableDictionaryRef temp(0);
 		if (inDict != 0)
 		{
-			temp = CFDictionaryCreateMutableCopy(kCFAllocatorDefault, 0, inDict);	
+			temp = CFDictionaryCreateMutableCopy(CFGetAllocator(inDict), 0, inDict);	
 		}
 		return temp;
 #endif
@@ -41,24 +68,59 @@ public:
 	QCDictionary( )
 	: dict( NULL)
 	, mDict( CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
+	// the dictionary, any copies made to modify it, and any dictionary created after this one is taken, come from inAllocator
+	explicit QCDictionary(CFAllocatorRef const inAllocator)
+	: dict( NULL)
+	, mDict( CFDictionaryCreateMutable(inAllocator, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( inAllocator )
+	{ }
+	
+	// takes ownership, but the caller may still be holding on to inDict, so the first mutation copies it
 	explicit QCDictionary(CFMutableDictionaryRef const &inDict)
 	: dict( NULL)
 	, mDict( inDict )
+	, ownership( kQCBorrowed )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
 	explicit QCDictionary(CFDictionaryRef const &inDict)
 	: dict( inDict )
 	, mDict( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, allocator( )
 	{ }
 	
 	// copy constructor
 	QCDictionary(QCDictionary const &inDict)
 	: dict( Retain(inDict.dict) )
 	, mDict( Retain(inDict.mDict) )
+	, ownership( inDict.share() )
+	, hashCode( inDict.hashCode.load(std::memory_order_relaxed) )
+	, allocator( inDict.allocator )
 	{ }
 	
+	// move constructor -- steals inDict's references; inDict is left null
+	QCDictionary(QCDictionary &&inDict) noexcept
+	: dict( inDict.dict )
+	, mDict( inDict.mDict )
+	, ownership( inDict.ownership.load(std::memory_order_relaxed) )
+	, hashCode( inDict.hashCode.load(std::memory_order_relaxed) )
+	, allocator( std::move(inDict.allocator) )
+	{
+		inDict.dict = NULL;
+		inDict.mDict = NULL;
+		inDict.hashCode.store(0, std::memory_order_relaxed);
+	}
+	
 	// destructor
 	~QCDictionary( )
 	{
@@ -85,26 +147,29 @@ public:
 				mDict = CFMutableDictionaryFromCFDictionary(dict);
 				Release(dict);
 				dict = NULL;
+				noteCopyOnWrite();
 			}
 			else
 			{
-				mDict = CFDictionaryCreateMutable(kCFAllocatorDefault
+				mDict = CFDictionaryCreateMutable(allocator.get()
 												  , 0
 												  , &kCFTypeDictionaryKeyCallBacks
 												  , &kCFTypeDictionaryValueCallBacks);
 			}
-
+			ownership = kQCOwnedUnique;
 		}
 	}
 	
 	void makeUnique()
 	{
-		if (! null() && CFGetRetainCount(Dictionary()) > 1)
+		// an immutable 'dict' is copied by makeMutable; only a shared 'mDict' needs copying here
+		if (!isNull(mDict) && ownership != kQCOwnedUnique && !Detail::reclaimShared(ownership, mDict))
 		{
-			CFMutableDictionaryRef newDict = CFDictionaryCreateMutableCopy(kCFAllocatorDefault, 0, Dictionary());
-			Release(Dictionary());
-			dict = NULL;
+			CFMutableDictionaryRef newDict = CFDictionaryCreateMutableCopy(CFGetAllocator(mDict), 0, mDict);
+			CFRelease(mDict);
 			mDict = newDict;
+			ownership = kQCOwnedUnique;
+			noteCopyOnWrite();
 		}
 	}
 	
@@ -113,9 +178,23 @@ public:
 		return isNull(Dictionary());
 	}
 	
+	// CFHash of the contents; memoized while they are immutable, recomputed while they may still change
+	// (as they may in anything holding a mutable reference, which includes whatever dictionaryFromFile returns)
+	CFHashCode hash() const
+	{
+		// relaxed is enough: any thread that computes the hash computes the same value
+		CFHashCode const cached = hashCode.load(std::memory_order_relaxed);
+		if (cached != 0 && isNull(mDict)) return cached;
+		
+		CFTypeRef const ref = Dictionary();
+		CFHashCode const h = isNull(ref) ? 0 : CFHash(ref);
+		if (isNull(mDict)) hashCode.store(h, std::memory_order_relaxed);
+		return h;
+	}
+	
 	CFIndex count() const
 	{
-		return null() ? 0 : CFDictionaryGetCount(dict);
+		return null() ? 0 : CFDictionaryGetCount(Dictionary());
 	}
 	
 	bool empty() const
@@ -128,6 +207,16 @@ public:
 		return QCDictionary(*this); // null() ? QCDictionary() : QCDictionary(CFDictionaryCreateMutableCopy(kCFAllocatorDefault, 0, dict));
 	}
 	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this dictionary null
+	CFDictionaryRef take() &&
+	{
+		CFDictionaryRef const d = Dictionary();
+		mDict = NULL;
+		dict = NULL;
+		hashCode.store(0, std::memory_order_relaxed);
+		return d;
+	}
+	
 	// operators
 	
 	// copy assignment
@@ -137,6 +226,20 @@ public:
 		QCDictionary temp(rhs);
 		std::swap(dict, temp.dict);
 		std::swap(mDict, temp.mDict);
+		Detail::swapRelaxed(ownership, temp.ownership);
+		Detail::swapRelaxed(hashCode, temp.hashCode);
+		allocator.swap(temp.allocator);
+		return *this;
+	}
+	
+	// move assignment
+	QCDictionary & operator = (QCDictionary &&rhs) noexcept
+	{
+		std::swap(dict, rhs.dict);
+		std::swap(mDict, rhs.mDict);
+		Detail::swapRelaxed(ownership, rhs.ownership);
+		Detail::swapRelaxed(hashCode, rhs.hashCode);
+		allocator.swap(rhs.allocator);
 		return *this;
 	}
 	
@@ -297,13 +400,14 @@ public:
 	
 	bool writeToFile(QCString const &filePath, CFPropertyListFormat const format = kCFPropertyListXMLFormat_v1_0) const;
 	
-	static QCDictionary dictionaryFromFile(QCString const &filePath)
+	// pass an ArenaAllocator (QCArenaAllocator.h) to parse a large file without a malloc per object
+	static QCDictionary dictionaryFromFile(QCString const &filePath, CFAllocatorRef const allocator = kCFAllocatorDefault)
 	{
 		CFPropertyListFormat plistFormat;
-		return dictionaryFromFile(filePath, plistFormat);
+		return dictionaryFromFile(filePath, plistFormat, allocator);
 	}
 	
-	static QCDictionary dictionaryFromFile(QCString const &filePath, CFPropertyListFormat &plistFormat);
+	static QCDictionary dictionaryFromFile(QCString const &filePath, CFPropertyListFormat &plistFormat, CFAllocatorRef const allocator = kCFAllocatorDefault);
 	
 };
 
@@ -311,4 +415,6 @@ typedef QCDictionary const QCFixedDictionary;
 
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCDictionary, CFDictionaryRef)
+
 #endif
@@ -9,8 +9,93 @@
 
 #include "QCNumber.h"
 
+#include <cstring>
+
 BEGIN_QC_NAMESPACE
 
+static_assert(QC_NUMBER_CACHE_MIN <= QC_NUMBER_CACHE_MAX, "QC_NUMBER_CACHE_MIN must not exceed QC_NUMBER_CACHE_MAX.");
+
+namespace
+{
+	// values compared bit for bit, so -0.0 and NaN are never served from the cache
+	double const kCommonDoubles[] = { 0.0, 1.0, -1.0, 0.5, 2.0, 10.0, 100.0 };
+	size_t const kCommonDoubleCount = sizeof(kCommonDoubles) / sizeof(kCommonDoubles[0]);
+	
+	long long const kIntegerCount = static_cast<long long>(QC_NUMBER_CACHE_MAX) - QC_NUMBER_CACHE_MIN + 1;
+	
+	// Built once, on first use, and never freed.
+	// int and long long get separate tables because CFNumberGetType reports the type a number was made with.
+	struct NumberCache
+	{
+		CFNumberRef ints[kIntegerCount];
+		CFNumberRef longLongs[kIntegerCount];
+		CFNumberRef doubles[kCommonDoubleCount];
+		
+		NumberCache()
+		{
+			for (long long i = 0; i < kIntegerCount; ++i)
+			{
+				int const intValue = static_cast<int>(i + QC_NUMBER_CACHE_MIN);
+				long long const longLongValue = i + QC_NUMBER_CACHE_MIN;
+				ints[i] = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &intValue);
+				longLongs[i] = CFNumberCreate(kCFAllocatorDefault, kCFNumberLongLongType, &longLongValue);
+			}
+			for (size_t i = 0; i < kCommonDoubleCount; ++i)
+			{
+				doubles[i] = CFNumberCreate(kCFAllocatorDefault, kCFNumberDoubleType, &kCommonDoubles[i]);
+			}
+		}
+	};
+	
+	NumberCache const &numberCache()
+	{
+		static NumberCache const * const cache = new NumberCache;
+		return *cache;
+	}
+	
+	inline bool inCacheRange(long long const value)
+	{
+		return value >= QC_NUMBER_CACHE_MIN && value <= QC_NUMBER_CACHE_MAX;
+	}
+}
+
+// static
+CFNumberRef QCNumber::cachedInt(int const value, CFAllocatorRef const allocator)
+{
+	if (allocator != kCFAllocatorDefault || !inCacheRange(value))
+	{
+		return NULL;
+	}
+	return numberCache().ints[value - QC_NUMBER_CACHE_MIN];
+}
+
+// static
+CFNumberRef QCNumber::cachedLongLong(long long const value, CFAllocatorRef const allocator)
+{
+	if (allocator != kCFAllocatorDefault || !inCacheRange(value))
+	{
+		return NULL;
+	}
+	return numberCache().longLongs[value - QC_NUMBER_CACHE_MIN];
+}
+
+// static
+CFNumberRef QCNumber::cachedDouble(double const value, CFAllocatorRef const allocator)
+{
+	if (allocator != kCFAllocatorDefault)
+	{
+		return NULL;
+	}
+	for (size_t i = 0; i < kCommonDoubleCount; ++i)
+	{
+		if (std::memcmp(&value, &kCommonDoubles[i], sizeof(double)) == 0)
+		{
+			return numberCache().doubles[i];
+		}
+	}
+	return NULL;
+}
+
 void QCNumber::show() const
 {
 #ifndef NDEBUG
@@ -12,54 +12,215 @@
 
 #include <CoreFoundation/CoreFoundation.h>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include "CFRaiiCommon.h"
 
+// Integers in [QC_NUMBER_CACHE_MIN, QC_NUMBER_CACHE_MAX] made with the default allocator
+// share preallocated, immortal CFNumbers. Define these at build time to change the range.
+#ifndef QC_NUMBER_CACHE_MIN
+#define QC_NUMBER_CACHE_MIN (-128)
+#endif
+
+#ifndef QC_NUMBER_CACHE_MAX
+#define QC_NUMBER_CACHE_MAX 1023
+#endif
+
 BEGIN_QC_NAMESPACE
 
+namespace Detail
+{
+	// MARK: compile-time CFNumber extraction
+	
+	enum NumberKind { kSignedNumber, kUnsignedNumber, kFloatNumber };
+	
+	template < class T >
+	struct NumberKindOf
+	{
+		static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value
+					  , "QCNumber values can only be read as non-bool arithmetic types.");
+		static NumberKind const value = std::is_floating_point<T>::value ? kFloatNumber
+										: std::is_signed<T>::value ? kSignedNumber
+										: kUnsignedNumber;
+	};
+	
+	// the fixed-width CFNumberType for a signed integer or floating-point type of a given size
+	template < NumberKind Kind, size_t Size > struct NumberTypeFor;
+	template <> struct NumberTypeFor<kSignedNumber, 1> { static CFNumberType const value = kCFNumberSInt8Type; };
+	template <> struct NumberTypeFor<kSignedNumber, 2> { static CFNumberType const value = kCFNumberSInt16Type; };
+	template <> struct NumberTypeFor<kSignedNumber, 4> { static CFNumberType const value = kCFNumberSInt32Type; };
+	template <> struct NumberTypeFor<kSignedNumber, 8> { static CFNumberType const value = kCFNumberSInt64Type; };
+	template <> struct NumberTypeFor<kFloatNumber, 4> { static CFNumberType const value = kCFNumberFloat32Type; };
+	template <> struct NumberTypeFor<kFloatNumber, 8> { static CFNumberType const value = kCFNumberFloat64Type; };
+	
+	// CFNumberGetValue returns false when the conversion loses information; so do we
+	template < class T, NumberKind Kind = NumberKindOf<T>::value >
+	struct NumberValue
+	{
+		static bool get(CFNumberRef const number, T &value)
+		{
+			return CFNumberGetValue(number, NumberTypeFor<Kind, sizeof(T)>::value, &value);
+		}
+	};
+	
+	/* CF's 128-bit integer type. The public CFNumberType enum leaves it out, but CFNumber creates and converts it
+	 * like any other, and NSNumber keeps unsigned 64-bit values above INT64_MAX in it.
+	 */
+	CFNumberType const kNumberSInt128Type = static_cast<CFNumberType>(17);
+	
+	struct NumberSInt128
+	{
+		SInt64	high;
+		UInt64	low;
+	};
+	
+	inline CFNumberRef createUnsignedNumber(UInt64 const value, CFAllocatorRef const allocator)
+	{
+		if (value <= static_cast<UInt64>(std::numeric_limits<SInt64>::max()))
+		{
+			long long const narrow = static_cast<long long>(value);
+			return CFNumberCreate(allocator, kCFNumberLongLongType, &narrow);
+		}
+		NumberSInt128 const wide = { 0, value };
+		return CFNumberCreate(allocator, kNumberSInt128Type, &wide);
+	}
+	
+	/* CFNumber has no unsigned types. Integers are read through the 128-bit type, so all of UInt64 comes back;
+	 * floats must be whole and in range. Either way only values that fit T exactly are accepted.
+	 */
+	template < class T >
+	struct NumberValue < T, kUnsignedNumber >
+	{
+		static bool get(CFNumberRef const number, T &value)
+		{
+			UInt64 wide = 0;
+			bool exact = false;
+			if (CFNumberIsFloatType(number))
+			{
+				double real = 0;
+				CFNumberGetValue(number, kCFNumberFloat64Type, &real);
+				// 2^64 is the first double out of range; NaN fails every comparison
+				exact = real >= 0 && real < 18446744073709551616.0
+					&& static_cast<double>(static_cast<UInt64>(real)) == real;
+				wide = exact ? static_cast<UInt64>(real) : 0;
+			}
+			else
+			{
+				NumberSInt128 big = { 0, 0 };
+				exact = CFNumberGetValue(number, kNumberSInt128Type, &big) && big.high == 0;
+				wide = big.low;
+			}
+			value = static_cast<T>(wide);
+			return exact && wide <= std::numeric_limits<T>::max();
+		}
+	};
+} /* Detail namespace */
+
 class QCNumber
 {
 private:
 	CFNumberRef number;
+	// number came from the cache: it is immortal, so we neither retain nor release it
+	bool cached;
+	
+	// cached instances, or NULL when value is out of range or allocator is not the default
+	static CFNumberRef cachedInt(int const value, CFAllocatorRef const allocator);
+	static CFNumberRef cachedLongLong(long long const value, CFAllocatorRef const allocator);
+	static CFNumberRef cachedDouble(double const value, CFAllocatorRef const allocator);
+	
+	static CFNumberRef cachedIndex(CFIndex const value, CFAllocatorRef const allocator)
+	{
+		// keep the CFNumberType the uncached path would have produced
+		return (sizeof(CFIndex) == sizeof(int)) ? cachedInt(static_cast<int>(value), allocator)
+												: cachedLongLong(value, allocator);
+	}
 	
 public:
 	
 	QCNumber()
 	: number( NULL )
+	, cached( false )
 	{ }
 	
 	explicit QCNumber(CFNumberRef const &inNum)
 	: number( inNum )
+	, cached( false )
 	{ }
 	
-	explicit QCNumber(CFIndex const &inNum)
-	: number( CFNumberCreate(kCFAllocatorDefault, kCFNumberCFIndexType, &inNum) )
-	{ }
+	explicit QCNumber(CFIndex const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( cachedIndex(inNum, allocator) )
+	, cached( isNotNull(number) )
+	{
+		if (!cached) number = CFNumberCreate(allocator, kCFNumberCFIndexType, &inNum);
+	}
 	
-	explicit QCNumber(int const &inNum)
-	: number( CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &inNum) )
-	{ }
+	explicit QCNumber(int const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( cachedInt(inNum, allocator) )
+	, cached( isNotNull(number) )
+	{
+		if (!cached) number = CFNumberCreate(allocator, kCFNumberIntType, &inNum);
+	}
 	
-	explicit QCNumber(float const &inNum)
-	: number( CFNumberCreate(kCFAllocatorDefault, kCFNumberFloatType, &inNum) )
+	explicit QCNumber(float const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( CFNumberCreate(allocator, kCFNumberFloatType, &inNum) )
+	, cached( false )
 	{ }
 	
-	explicit QCNumber(double const &inNum)
-	: number( CFNumberCreate(kCFAllocatorDefault, kCFNumberDoubleType, &inNum) )
-	{ }
+	explicit QCNumber(double const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( cachedDouble(inNum, allocator) )
+	, cached( isNotNull(number) )
+	{
+		if (!cached) number = CFNumberCreate(allocator, kCFNumberDoubleType, &inNum);
+	}
 	
-	explicit QCNumber(long long const &inNum)
-	: number( CFNumberCreate(kCFAllocatorDefault, kCFNumberLongLongType, &inNum) )
-	{ }
+	explicit QCNumber(long long const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( cachedLongLong(inNum, allocator) )
+	, cached( isNotNull(number) )
+	{
+		if (!cached) number = CFNumberCreate(allocator, kCFNumberLongLongType, &inNum);
+	}
+	
+	// values above INT64_MAX go in CF's 128-bit type, which try_get<unsigned long long> reads back
+	explicit QCNumber(unsigned long long const &inNum, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: number( (inNum <= static_cast<unsigned long long>(std::numeric_limits<long long>::max()))
+				? cachedLongLong(static_cast<long long>(inNum), allocator) : NULL )
+	, cached( isNotNull(number) )
+	{
+		if (!cached) number = Detail::createUnsignedNumber(inNum, allocator);
+	}
 	
 	// copy constructor
 	QCNumber(QCNumber const &inNum)
-	: number( Retain(inNum.number) )
+	: number( inNum.cached ? inNum.number : Retain(inNum.number) )
+	, cached( inNum.cached )
 	{ }
 	
+	// move constructor -- steals inNum's reference; inNum is left null
+	QCNumber(QCNumber &&inNum) noexcept
+	: number( inNum.number )
+	, cached( inNum.cached )
+	{
+		inNum.number = NULL;
+		inNum.cached = false;
+	}
+	
 	// destructor
 	~QCNumber()
 	{
-		Release(number);
+		if (!cached) Release(number);
+	}
+	
+	bool isCached() const
+	{
+		return cached;
+	}
+	
+	// not memoized: CFNumber hashes in constant time
+	CFHashCode hash() const
+	{
+		return null() ? 0 : CFHash(number);
 	}
 	
 	bool null() const
@@ -109,20 +270,177 @@ public:
 	{
 		QCNumber temp(rhs);
 		std::swap(number, temp.number);
+		std::swap(cached, temp.cached);
 		return *this;
 	}
 	
+	// move assignment
+	QCNumber & operator = (QCNumber &&rhs) noexcept
+	{
+		std::swap(number, rhs.number);
+		std::swap(cached, rhs.cached);
+		return *this;
+	}
+	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this number null
+	CFNumberRef take() &&
+	{
+		CFNumberRef const num = number;
+		if (cached)
+		{
+			// the caller gets a reference of its own; the cache keeps the original
+			CFRetain(num);
+		}
+		number = NULL;
+		cached = false;
+		return num;
+	}
+	
 	// conversion operator
 	operator CFNumberRef () const
 	{
 		return number;
 	}
 	
+	// MARK: value extraction
+	
+	// false if null, or if the value does not fit T without loss
+	template < class T >
+	bool try_get(T &value) const
+	{
+		return isNotNull(number) && Detail::NumberValue<T>::get(number, value);
+	}
+	
+	// throws std::range_error if null, or if the value does not fit T without loss
+	template < class T >
+	T get() const
+	{
+		T value = T();
+		if (!try_get(value))
+		{
+			throw std::range_error("QCNumber value does not fit the requested type");
+		}
+		return value;
+	}
+	
+	template < class T >
+	T value_or(T const fallback) const
+	{
+		T value = T();
+		return try_get(value) ? value : fallback;
+	}
+	
+	// Bulk versions for arrays of CFNumbers, e.g. from a parsed plist.
+	// try_get_all stops at the first element that is not a number or does not fit T, and returns false;
+	// values then holds the elements before it.
+	template < class T >
+	static bool try_get_all(CFArrayRef const array, std::vector<T> &values);
+	
+	// throws std::range_error where try_get_all would return false
+	template < class T >
+	static std::vector<T> get_all(CFArrayRef const array)
+	{
+		std::vector<T> values;
+		if (!try_get_all(array, values))
+		{
+			throw std::range_error("QCNumber array element does not fit the requested type");
+		}
+		return values;
+	}
+	
+	// one entry per element; fallback stands in for anything that is not a number or does not fit T
+	template < class T >
+	static std::vector<T> values_or(CFArrayRef const array, T const fallback);
+	
 	void show() const;
+	
+private:
+	// hands elements of array to f in chunks, without allocating
+	template < class F >
+	static void forEachElement(CFArrayRef const array, F f)
+	{
+		CFIndex const count = isNull(array) ? 0 : CFArrayGetCount(array);
+		CFTypeRef chunk[256];
+		CFIndex const chunkSize = sizeof(chunk) / sizeof(chunk[0]);
+		
+		for (CFIndex start = 0; start < count; start += chunkSize)
+		{
+			CFIndex const length = std::min(chunkSize, count - start);
+			CFArrayGetValues(array, CFRangeMake(start, length), chunk);
+			for (CFIndex i = 0; i < length; ++i)
+			{
+				if (!f(chunk[i])) return;
+			}
+		}
+	}
 };
 
+template < class T >
+bool QCNumber::try_get_all(CFArrayRef const array, std::vector<T> &values)
+{
+	CFTypeID const numberID = CFNumberGetTypeID();
+	bool ok = true;
+	
+	values.clear();
+	values.reserve(isNull(array) ? 0 : CFArrayGetCount(array));
+	forEachElement(array, [&](CFTypeRef const element) -> bool
+	{
+		T value = T();
+		ok = isNotNull(element)
+			&& CFGetTypeID(element) == numberID
+			&& Detail::NumberValue<T>::get(static_cast<CFNumberRef>(element), value);
+		if (ok) values.push_back(value);
+		return ok;
+	});
+	return ok;
+}
+
+template < class T >
+std::vector<T> QCNumber::values_or(CFArrayRef const array, T const fallback)
+{
+	CFTypeID const numberID = CFNumberGetTypeID();
+	std::vector<T> values;
+	
+	values.reserve(isNull(array) ? 0 : CFArrayGetCount(array));
+	forEachElement(array, [&](CFTypeRef const element) -> bool
+	{
+		T value = T();
+		bool const ok = isNotNull(element)
+			&& CFGetTypeID(element) == numberID
+			&& Detail::NumberValue<T>::get(static_cast<CFNumberRef>(element), value);
+		values.push_back(ok ? value : fallback);
+		return true;
+	});
+	return values;
+}
+
 typedef QCNumber const QCFixedNumber;
 
+// MARK: -
+// MARK: QCNumberLess
+
+// numeric order across CFNumber types, for std::sort and QCArray::sort
+struct QCNumberLess
+{
+	// a CFComparatorFunction, for CFArraySortValues and CFArrayBSearchValues on arrays of CFNumbers
+	static CFComparisonResult compareValues(void const *lhs, void const *rhs, void *)
+	{
+		return CFNumberCompare(static_cast<CFNumberRef> (lhs), static_cast<CFNumberRef> (rhs), NULL);
+	}
+	
+	bool operator () (CFNumberRef const lhs, CFNumberRef const rhs) const
+	{
+		return CFNumberCompare(lhs, rhs, NULL) == kCFCompareLessThan;
+	}
+	
+	bool operator () (QCNumber const &lhs, QCNumber const &rhs) const
+	{
+		return CFNumberCompare(lhs, rhs, NULL) == kCFCompareLessThan;
+	}
+};
+
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCNumber, CFNumberRef)
+
 #endif
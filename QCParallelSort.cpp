@@ -0,0 +1,330 @@
+/*
+ *  QCParallelSort.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCParallelSort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "QCUtilities.h"
+
+BEGIN_QC_NAMESPACE
+
+namespace
+{
+	struct SortKey
+	{
+		UInt64		key;
+		CFTypeRef	value;
+	};
+
+	typedef std::vector<SortKey>::const_iterator SortKeyIterator;
+
+	UInt64 const kSignBit = UInt64(1) << 63;
+
+	// MARK: key extraction
+
+	// the first four UTF-16 units, the first in the top bits; a missing unit counts as 0, and ties go to the full comparison
+	UInt64 stringKey(CFStringRef const str)
+	{
+		CFIndex const length = std::min<CFIndex>(CFStringGetLength(str), 4);
+		UniChar units[4] = { 0, 0, 0, 0 };
+
+		char const * const ascii = CFStringGetCStringPtr(str, kCFStringEncodingASCII);
+		if (ascii != NULL)
+		{
+			for (CFIndex i = 0; i < length; ++i)
+			{
+				units[i] = static_cast<unsigned char> (ascii[i]);
+			}
+		}
+		else if (length > 0)
+		{
+			CFStringGetCharacters(str, CFRangeMake(0, length), units);
+		}
+
+		return (UInt64(units[0]) << 48) | (UInt64(units[1]) << 32) | (UInt64(units[2]) << 16) | UInt64(units[3]);
+	}
+
+	// two's complement reordered so that unsigned comparison follows signed order
+	inline UInt64 integerKey(SInt64 const value)
+	{
+		return static_cast<UInt64> (value) ^ kSignBit;
+	}
+
+	// IEEE 754 bits reordered so that unsigned comparison follows numeric order; NaNs go last
+	inline UInt64 doubleKey(double const value)
+	{
+		if (value != value)
+		{
+			return ~UInt64(0);
+		}
+
+		UInt64 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+	}
+
+	struct StringKeyLess
+	{
+		bool operator () (SortKey const &lhs, SortKey const &rhs) const
+		{
+			if (lhs.key != rhs.key) return lhs.key < rhs.key;
+			return QCStringOrdinalLess::compare(static_cast<CFStringRef> (lhs.value)
+												, static_cast<CFStringRef> (rhs.value)) == kCFCompareLessThan;
+		}
+	};
+
+	struct NumberKeyLess
+	{
+		bool exact; // the keys are the integer values themselves, so equal keys are equal numbers
+
+		bool operator () (SortKey const &lhs, SortKey const &rhs) const
+		{
+			if (lhs.key != rhs.key) return lhs.key < rhs.key;
+			return !exact
+				&& CFNumberCompare(static_cast<CFNumberRef> (lhs.value)
+								   , static_cast<CFNumberRef> (rhs.value), NULL) == kCFCompareLessThan;
+		}
+	};
+
+	// MARK: threads
+
+	size_t threadsFor(CFIndex const count, unsigned const requested)
+	{
+		size_t threads = (requested != 0) ? requested : std::thread::hardware_concurrency();
+		CFIndex const useful = std::max<CFIndex>(1, count / QCParallelSort::kMinimumPerThread);
+		return std::max<size_t>(1, std::min(threads, static_cast<size_t>(useful)));
+	}
+
+	// first element of slice i when count elements are cut into slices nearly equal parts
+	inline size_t sliceStart(size_t const count, size_t const slices, size_t const i)
+	{
+		return count * i / slices;
+	}
+
+	// runs task(0) ... task(tasks - 1) at the same time, task(0) on the calling thread
+	template < class F >
+	void runParallel(size_t const tasks, F const &task)
+	{
+		std::vector<std::thread> workers;
+		workers.reserve(tasks);
+		try
+		{
+			for (size_t i = 1; i < tasks; ++i)
+			{
+				workers.push_back(std::thread([&task, i] { task(i); }));
+			}
+			task(0);
+		}
+		catch (...)
+		{
+			// a std::thread destroyed while still joinable would end the process
+			for (size_t i = 0; i < workers.size(); ++i)
+			{
+				workers[i].join();
+			}
+			throw;
+		}
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			workers[i].join();
+		}
+	}
+
+	// Calls extract(value, key) for every element, a slice per thread.
+	// Returns the index of an element extract rejected, or kCFNotFound.
+	template < class F >
+	CFIndex extractKeys(std::vector<CFTypeRef> const &values, std::vector<SortKey> &keys, size_t const threads, F const &extract)
+	{
+		std::vector<CFIndex> rejected(threads, kCFNotFound);
+		size_t const count = values.size();
+
+		runParallel(threads, [&](size_t const slice)
+		{
+			for (size_t i = sliceStart(count, threads, slice); i < sliceStart(count, threads, slice + 1); ++i)
+			{
+				keys[i].value = values[i];
+				if (!extract(values[i], keys[i].key))
+				{
+					rejected[slice] = static_cast<CFIndex> (i);
+					return;
+				}
+			}
+		});
+
+		for (size_t slice = 0; slice < threads; ++slice)
+		{
+			if (rejected[slice] != kCFNotFound) return rejected[slice];
+		}
+		return kCFNotFound;
+	}
+
+	// MARK: sorting
+
+	/* Merges [lo, mid) and [mid, hi) of from into the same places in to; or rather piece part of parts of that merge.
+	 * The left run is cut evenly and the right run where the left's cut points would go,
+	 * so the pieces can be merged independently and end up side by side.
+	 */
+	template < class Less >
+	void mergePiece(std::vector<SortKey> const &from, size_t const lo, size_t const mid, size_t const hi
+					, size_t const part, size_t const parts, Less const &less, std::vector<SortKey> &to)
+	{
+		SortKeyIterator const left = from.begin() + lo;
+		SortKeyIterator const right = from.begin() + mid;
+		SortKeyIterator const end = from.begin() + hi;
+
+		SortKeyIterator leftCuts[2], rightCuts[2];
+		for (size_t n = 0; n < 2; ++n)
+		{
+			size_t const cut = part + n;
+			leftCuts[n] = left + (mid - lo) * cut / parts;
+			rightCuts[n] = (cut == 0) ? right
+						 : (leftCuts[n] == right) ? end
+						 : std::lower_bound(right, end, *leftCuts[n], less);
+		}
+
+		std::merge(leftCuts[0], leftCuts[1], rightCuts[0], rightCuts[1]
+				   , to.begin() + lo + (leftCuts[0] - left) + (rightCuts[0] - right), less);
+	}
+
+	template < class Less >
+	void parallelSort(std::vector<SortKey> &keys, size_t const threads, Less const &less)
+	{
+		size_t const count = keys.size();
+
+		runParallel(threads, [&](size_t const slice)
+		{
+			std::sort(keys.begin() + sliceStart(count, threads, slice)
+					  , keys.begin() + sliceStart(count, threads, slice + 1), less);
+		});
+
+		// merge neighbouring runs, doubling their width each round; every merge gets a thread per slice it covers
+		std::vector<SortKey> scratch(threads > 1 ? count : 0);
+		std::vector<SortKey> *from = &keys;
+		std::vector<SortKey> *to = &scratch;
+		for (size_t width = 1; width < threads; width *= 2)
+		{
+			runParallel(threads, [&](size_t const i)
+			{
+				size_t const first = i - i % (2 * width);
+				size_t const lo = sliceStart(count, threads, first);
+				size_t const mid = sliceStart(count, threads, std::min(first + width, threads));
+				size_t const hi = sliceStart(count, threads, std::min(first + 2 * width, threads));
+				mergePiece(*from, lo, mid, hi, i - first, std::min(2 * width, threads - first), less, *to);
+			});
+			std::swap(from, to);
+		}
+
+		if (from != &keys)
+		{
+			keys.swap(scratch);
+		}
+	}
+
+	void replaceSorted(QCArray &array, std::vector<SortKey> const &keys, std::vector<CFTypeRef> &values)
+	{
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			values[i] = keys[i].value;
+		}
+		array.ReplaceValues(CFRangeMake(0, static_cast<CFIndex> (values.size())), &values[0], static_cast<CFIndex> (values.size()));
+	}
+}
+
+// static
+void QCParallelSort::sort(QCArray &strings, QCStringOrdinalLess const &, unsigned const threadCount)
+{
+	CFIndex const count = strings.GetCount();
+	if (count < 2)
+	{
+		return;
+	}
+
+	std::vector<CFTypeRef> values(static_cast<size_t>(count));
+	CFArrayGetValues(strings.Array(), CFRangeMake(0, count), &values[0]);
+
+	size_t const threads = threadsFor(count, threadCount);
+	std::vector<SortKey> keys(values.size());
+	CFTypeID const stringID = CFStringGetTypeID();
+
+	CFIndex const rejected = extractKeys(values, keys, threads, [stringID](CFTypeRef const value, UInt64 &key) -> bool
+	{
+		if (isNull(value) || CFGetTypeID(value) != stringID) return false;
+		key = stringKey(static_cast<CFStringRef> (value));
+		return true;
+	});
+	if (rejected != kCFNotFound)
+	{
+		CFTypeRef const value = values[rejected];
+		throw CFRaiiException(stringID, isNull(value) ? 0 : CFGetTypeID(value));
+	}
+
+	parallelSort(keys, threads, StringKeyLess());
+	replaceSorted(strings, keys, values);
+}
+
+// static
+void QCParallelSort::sort(QCArray &numbers, QCNumberLess const &, unsigned const threadCount)
+{
+	CFIndex const count = numbers.GetCount();
+	if (count < 2)
+	{
+		return;
+	}
+
+	std::vector<CFTypeRef> values(static_cast<size_t>(count));
+	CFArrayGetValues(numbers.Array(), CFRangeMake(0, count), &values[0]);
+
+	size_t const threads = threadsFor(count, threadCount);
+	std::vector<SortKey> keys(values.size());
+	CFTypeID const numberID = CFNumberGetTypeID();
+
+	// integer keys are exact; one float (or an integer beyond 64 bits) and every key is made from a double instead
+	std::atomic<bool> integral(true);
+	CFIndex const rejected = extractKeys(values, keys, threads, [numberID, &integral](CFTypeRef const value, UInt64 &key) -> bool
+	{
+		if (isNull(value) || CFGetTypeID(value) != numberID) return false;
+
+		CFNumberRef const number = static_cast<CFNumberRef> (value);
+		SInt64 integer = 0;
+		if (CFNumberIsFloatType(number) || !CFNumberGetValue(number, kCFNumberSInt64Type, &integer))
+		{
+			integral.store(false, std::memory_order_relaxed);
+		}
+		key = integerKey(integer);
+		return true;
+	});
+	if (rejected != kCFNotFound)
+	{
+		CFTypeRef const value = values[rejected];
+		throw CFRaiiException(numberID, isNull(value) ? 0 : CFGetTypeID(value));
+	}
+
+	NumberKeyLess less = { integral.load() };
+	if (!less.exact)
+	{
+		extractKeys(values, keys, threads, [](CFTypeRef const value, UInt64 &key) -> bool
+		{
+			double real = 0;
+			CFNumberGetValue(static_cast<CFNumberRef> (value), kCFNumberDoubleType, &real);
+			key = doubleKey(real);
+			return true;
+		});
+	}
+
+	parallelSort(keys, threads, less);
+	replaceSorted(numbers, keys, values);
+}
+
+END_QC_NAMESPACE
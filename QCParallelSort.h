@@ -0,0 +1,49 @@
+/*
+ *  QCParallelSort.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Sorts very large arrays of CFStrings or CFNumbers on several threads.
+ * Every element's sort key is extracted once, up front: the first four UTF-16 units of a string,
+ * or a number's value mapped to an order-preserving 64-bit integer.
+ * Most comparisons are then a single integer compare; only keys that tie go back to the full comparison.
+ * Slices are sorted concurrently and merged pairwise, each merge also split across the threads,
+ * and the result is written back with one CFArrayReplaceValues.
+ */
+
+#ifndef _QC_PARALLEL_SORT_GUARD_
+#define _QC_PARALLEL_SORT_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include "CFRaiiCommon.h"
+
+#include "QCArray.h"
+#include "QCNumber.h"
+#include "QCStringCompare.h"
+
+BEGIN_QC_NAMESPACE
+
+struct QCParallelSort
+{
+	// below this many elements per thread, another thread costs more than it saves
+	static CFIndex const kMinimumPerThread = 16 * 1024;
+
+	/* A threadCount of 0 uses every core; small arrays use fewer threads than asked for.
+	 * Elements that compare equal may be reordered.
+	 * If an element is of the wrong type, CFRaiiException is thrown and the array is unchanged.
+	 */
+
+	// the same order as QCArray::sort(QCStringOrdinalLess())
+	static void sort(QCArray &strings, QCStringOrdinalLess const &, unsigned const threadCount = 0);
+
+	// the same order as QCArray::sort(QCNumberLess()), except that NaNs sort after +infinity
+	static void sort(QCArray &numbers, QCNumberLess const &, unsigned const threadCount = 0);
+};
+
+END_QC_NAMESPACE
+
+#endif
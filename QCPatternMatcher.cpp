@@ -0,0 +1,185 @@
+/*
+ *  QCPatternMatcher.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCPatternMatcher.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "QCUtilities.h"
+
+BEGIN_QC_NAMESPACE
+
+QCPatternMatcher::QCPatternMatcher()
+: nodes( )
+, patternCount( 0 )
+, compiled( false )
+{
+	std::fill(rootTable, rootTable + kRootTableSize, -1);
+	newNode(0); // the root
+}
+
+QCPatternMatcher::QCPatternMatcher(CFArrayRef const &patterns)
+: nodes( )
+, patternCount( 0 )
+, compiled( false )
+{
+	std::fill(rootTable, rootTable + kRootTableSize, -1);
+	newNode(0);
+
+	CFIndex const count = isNull(patterns) ? 0 : CFArrayGetCount(patterns);
+	std::vector<CFTypeRef> values(static_cast<size_t>(count));
+	if (count > 0)
+	{
+		CFArrayGetValues(patterns, CFRangeMake(0, count), &values[0]);
+	}
+
+	// every element is checked before any is added; NULL is allowed, as it is by add()
+	CFTypeID const stringID = CFStringGetTypeID();
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		if (isNotNull(values[i]) && CFGetTypeID(values[i]) != stringID)
+		{
+			throw CFRaiiException(stringID, CFGetTypeID(values[i]));
+		}
+	}
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		add(static_cast<CFStringRef> (values[i]));
+	}
+	compile();
+}
+
+int QCPatternMatcher::newNode(CFIndex const depth)
+{
+	Node node;
+	node.fail = 0;
+	node.output = -1;
+	node.outLink = -1;
+	node.depth = depth;
+
+	nodes.push_back(node);
+	return static_cast<int>(nodes.size() - 1);
+}
+
+size_t QCPatternMatcher::add(CFStringRef const &pattern)
+{
+	size_t const index = patternCount++;
+	compiled = false;
+
+	CFIndex const length = isNull(pattern) ? 0 : CFStringGetLength(pattern);
+	if (length == 0)
+	{
+		return index;
+	}
+
+	CFStringInlineBuffer buffer;
+	CFStringInitInlineBuffer(pattern, &buffer, CFRangeMake(0, length));
+
+	int node = 0;
+	for (CFIndex i = 0; i < length; ++i)
+	{
+		UniChar const c = CFStringGetCharacterFromInlineBuffer(&buffer, i);
+		int next = child(node, c);
+		if (next < 0)
+		{
+			next = newNode(i + 1);
+
+			std::vector<Edge> &edges = nodes[node].edges;
+			edges.insert(std::lower_bound(edges.begin(), edges.end(), Edge(c, -1)), Edge(c, next));
+			if (node == 0 && c < kRootTableSize)
+			{
+				rootTable[c] = next;
+			}
+		}
+		node = next;
+	}
+
+	if (nodes[node].output < 0)
+	{
+		nodes[node].output = static_cast<int>(index);
+	}
+	return index;
+}
+
+void QCPatternMatcher::compile()
+{
+	// breadth first, so every node's fail target is finished before the node itself
+	std::deque<int> pending;
+
+	for (std::vector<Edge>::const_iterator it = nodes[0].edges.begin(); it != nodes[0].edges.end(); ++it)
+	{
+		nodes[it->second].fail = 0;
+		nodes[it->second].outLink = -1;
+		pending.push_back(it->second);
+	}
+
+	while (!pending.empty())
+	{
+		int const node = pending.front();
+		pending.pop_front();
+
+		for (std::vector<Edge>::const_iterator it = nodes[node].edges.begin(); it != nodes[node].edges.end(); ++it)
+		{
+			int const target = it->second;
+			int const fail = step(nodes[node].fail, it->first);
+
+			nodes[target].fail = fail;
+			nodes[target].outLink = (nodes[fail].output >= 0) ? fail : nodes[fail].outLink;
+			pending.push_back(target);
+		}
+	}
+
+	compiled = true;
+}
+
+namespace
+{
+	struct CollectMatches
+	{
+		std::vector<QCPatternMatcher::Match> *matches;
+
+		bool operator () (QCPatternMatcher::Match const &match) const
+		{
+			matches->push_back(match);
+			return true;
+		}
+	};
+
+	struct StopAtFirst
+	{
+		bool *found;
+
+		bool operator () (QCPatternMatcher::Match const &) const
+		{
+			*found = true;
+			return false;
+		}
+	};
+}
+
+std::vector<QCPatternMatcher::Match> QCPatternMatcher::findAll(QCStringView const &text) const
+{
+	std::vector<Match> matches;
+	CollectMatches const collect = { &matches };
+	scan(text, collect);
+	return matches;
+}
+
+bool QCPatternMatcher::matchesAny(QCStringView const &text) const
+{
+	bool found = false;
+	StopAtFirst const stop = { &found };
+	scan(text, stop);
+	return found;
+}
+
+END_QC_NAMESPACE
@@ -0,0 +1,142 @@
+/*
+ *  QCPatternMatcher.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Finds any number of literal patterns in a single pass over the text (Aho-Corasick).
+ * Add the patterns, compile() once, then scan as many strings as you like;
+ * a compiled matcher is read-only, so it may be shared between threads.
+ * Matching is on UTF-16 units, with no case folding or normalization.
+ */
+
+#ifndef _QC_PATTERN_MATCHER_GUARD_
+#define _QC_PATTERN_MATCHER_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "CFRaiiCommon.h"
+
+#include "QCStringView.h"
+
+BEGIN_QC_NAMESPACE
+
+class QCPatternMatcher
+{
+public:
+	struct Match
+	{
+		CFIndex	location;	// relative to the scanned view
+		CFIndex	length;
+		size_t	pattern;	// index returned by add()
+	};
+
+private:
+	typedef std::pair<UniChar, int> Edge;	// character, child node
+
+	struct Node
+	{
+		std::vector<Edge>	edges;		// sorted by character
+		int					fail;		// longest proper suffix that is also a trie node
+		int					output;		// pattern ending here, or -1
+		int					outLink;	// nearest node on the fail chain with an output, or -1
+		CFIndex				depth;
+	};
+
+	// characters below this are looked up directly at the root, where most transitions land
+	static UniChar const kRootTableSize = 128;
+
+	std::vector<Node>	nodes;
+	int					rootTable[kRootTableSize];
+	size_t				patternCount;
+	bool				compiled;
+
+	int newNode(CFIndex const depth);
+	int child(int const node, UniChar const c) const
+	{
+		if (node == 0 && c < kRootTableSize)
+		{
+			return rootTable[c];
+		}
+
+		std::vector<Edge> const &edges = nodes[node].edges;
+		std::vector<Edge>::const_iterator const it = std::lower_bound(edges.begin(), edges.end(), Edge(c, -1));
+		return (it != edges.end() && it->first == c) ? it->second : -1;
+	}
+
+	// goto, falling back along fail links
+	int step(int state, UniChar const c) const
+	{
+		for ( ; ; )
+		{
+			int const next = child(state, c);
+			if (next >= 0) return next;
+			if (state == 0) return 0;
+			state = nodes[state].fail;
+		}
+	}
+
+public:
+	QCPatternMatcher();
+
+	// adds and compiles, e.g. from a QCArray of strings; throws CFRaiiException if an element is not a CFString
+	explicit QCPatternMatcher(CFArrayRef const &patterns);
+
+	// Returns the pattern's index, which is what matches report.
+	// An empty pattern never matches; a pattern added twice is reported under its first index.
+	size_t add(CFStringRef const &pattern);
+
+	// builds the fail links; call after the last add() and before scanning
+	void compile();
+
+	size_t count() const
+	{
+		return patternCount;
+	}
+
+	/* Calls onMatch(Match const &) for every occurrence of every pattern, overlapping ones included,
+	 * in order of where they end. Stops early if onMatch returns false.
+	 */
+	template < class F >
+	void scan(QCStringView const &text, F onMatch) const
+	{
+		if (!compiled)
+		{
+			throw std::logic_error("QCPatternMatcher must be compiled before scanning");
+		}
+		if (text.null() || text.empty())
+		{
+			return;
+		}
+
+		CFStringInlineBuffer buffer;
+		CFStringInitInlineBuffer(text.CFString(), &buffer, text.range());
+
+		int state = 0;
+		CFIndex const length = text.length();
+		for (CFIndex i = 0; i < length; ++i)
+		{
+			state = step(state, CFStringGetCharacterFromInlineBuffer(&buffer, i));
+
+			for (int n = (nodes[state].output >= 0) ? state : nodes[state].outLink; n >= 0; n = nodes[n].outLink)
+			{
+				Match const match = { i + 1 - nodes[n].depth, nodes[n].depth, static_cast<size_t>(nodes[n].output) };
+				if (!onMatch(match)) return;
+			}
+		}
+	}
+
+	std::vector<Match> findAll(QCStringView const &text) const;
+
+	bool matchesAny(QCStringView const &text) const;
+};
+
+END_QC_NAMESPACE
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ *  QCRef.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* One-word smart pointer for CF objects.
+ * Unlike QCSharedPtr, which layers a std::tr1::shared_ptr control block on top of the object,
+ * QCRef uses the object's own retain count and nothing else.
+ */
+
+#ifndef _QC_REF_GUARD_
+#define _QC_REF_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "CFRaiiCommon.h"
+#include "QCTypeTraits.h"
+
+BEGIN_QC_NAMESPACE
+
+template < class CF >
+class QCRef
+{
+static_assert(is_CFType<CF>::value, "QCRef is only compatible with Core Foundation types.");
+	template < class Other > friend class QCRef;
+
+private:
+	CF _ref;
+
+public:
+	typedef CF element_type;
+
+	QCRef()
+	: _ref( NULL )
+	{ }
+
+	// takes ownership -- use for references that follow the Create rule
+	explicit QCRef(CF const ref)
+	: _ref( ref )
+	{ }
+
+	// shares ownership -- use for references that follow the Get rule
+	static QCRef retaining(CF const ref)
+	{
+		if (ref != NULL) CFRetain(ref);
+		return QCRef(ref);
+	}
+
+	// copy ctor
+	QCRef(QCRef const &rhs)
+	: _ref( rhs._ref )
+	{
+		if (_ref != NULL) CFRetain(_ref);
+	}
+
+	// move ctor -- the reference changes hands without touching the retain count
+	QCRef(QCRef &&rhs) noexcept
+	: _ref( rhs._ref )
+	{
+		rhs._ref = NULL;
+	}
+
+	// e.g. QCRef<CFMutableArrayRef> to QCRef<CFArrayRef>
+	template < class Other >
+	QCRef(QCRef<Other> const &rhs, typename std::enable_if<std::is_convertible<Other, CF>::value>::type * = NULL)
+	: _ref( rhs._ref )
+	{
+		if (_ref != NULL) CFRetain(_ref);
+	}
+
+	template < class Other >
+	QCRef(QCRef<Other> &&rhs, typename std::enable_if<std::is_convertible<Other, CF>::value>::type * = NULL) noexcept
+	: _ref( rhs._ref )
+	{
+		rhs._ref = NULL;
+	}
+
+	// dtor
+	~QCRef()
+	{
+		if (_ref != NULL) CFRelease(_ref);
+	}
+
+	// copy and move assignment -- rhs is already our copy, so just swap
+	QCRef & operator = (QCRef rhs) noexcept
+	{
+		swap(rhs);
+		return *this;
+	}
+
+	void swap(QCRef &rhs) noexcept
+	{
+		std::swap(_ref, rhs._ref);
+	}
+
+	void reset()
+	{
+		QCRef().swap(*this);
+	}
+
+	// takes ownership of ref
+	void reset(CF const ref)
+	{
+		QCRef(ref).swap(*this);
+	}
+
+	// gives up ownership without releasing; the caller must CFRelease the result
+	CF yield()
+	{
+		CF const ref = _ref;
+		_ref = NULL;
+		return ref;
+	}
+
+	CF get() const
+	{
+		return _ref;
+	}
+
+	// CF's retain count, not the number of QCRefs
+	long use_count() const
+	{
+		return (_ref == NULL) ? 0 : CFGetRetainCount(_ref);
+	}
+	bool unique() const
+	{
+		return use_count() == 1;
+	}
+	operator bool() const
+	{
+		return _ref != NULL;
+	}
+
+	// pointer equality; use Equal() for CFEqual
+	template < class Other >
+	bool operator == (QCRef<Other> const &rhs) const
+	{
+		return _ref == rhs._ref;
+	}
+	template < class Other >
+	bool operator != (QCRef<Other> const &rhs) const
+	{
+		return _ref != rhs._ref;
+	}
+
+public:
+	// CoreFoundation functions that apply to all CFTypes
+	CFStringRef CopyDescription() const		{ return CFCopyDescription(get()); }
+	Boolean Equal(CFTypeRef const rhs) const	{ return CFEqual(get(), rhs); }
+	CFAllocatorRef GetAllocator() const		{ return CFGetAllocator(get()); }
+	CFIndex GetRetainCount() const			{ return CFGetRetainCount(get()); }
+	CFTypeID GetTypeID() const				{ return CFGetTypeID(get()); }
+	CFHashCode Hash() const					{ return CFHash(get()); }
+	void Show() const						{ CFShow(get()); }
+
+	// Conceptually non-const memory-management methods.
+	// Return get() to preserve type information that would otherwise become CFTypeRef.
+	CF MakeCollectible()					{ CFMakeCollectable(get()); return get(); }
+	CF Retain()								{ CFRetain(get()); return get(); }
+	void Release()							{ CFRelease(get()); }
+};
+
+static_assert(sizeof(QCRef<CFTypeRef>) == sizeof(CFTypeRef), "QCRef must stay the size of one pointer.");
+
+END_QC_NAMESPACE
+
+#endif
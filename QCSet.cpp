@@ -14,7 +14,7 @@ BEGIN_QC_NAMESPACE
 void QCSet::show() const
 {
 #ifndef NDEBUG
-	CFShow(set);
+	CFShow(Set());
 #endif
 }
 
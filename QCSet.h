@@ -21,21 +21,52 @@ class QCSet
 private:
 	CFMutableSetRef	mSet;
 	CFSetRef		set;
+	// who else can see mSet; meaningless while mSet is NULL
+	mutable std::atomic<QCOwnership>	ownership;
+	// what a set is created from while we hold none
+	Detail::HeldAllocator	allocator;
+	
+	// another wrapper is about to hold our mutable set; neither of us may modify it in place any more
+	QCOwnership share() const
+	{
+		if (isNotNull(mSet))
+		{
+			// a borrowed reference stays borrowed, or reclaimShared could later hand the caller's object back to us
+			QCOwnership expected = kQCOwnedUnique;
+			ownership.compare_exchange_strong(expected, kQCShared, std::memory_order_relaxed);
+		}
+		return ownership.load(std::memory_order_relaxed);
+	}
 	
 public:
 	QCSet( )
 	: set( NULL )
 	, mSet( CFSetCreateMutable(kCFAllocatorDefault, 0, &kCFTypeSetCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, allocator( )
 	{ }
 	
+	// the set, any copies made to modify it, and any set created after this one is taken, come from inAllocator
+	explicit QCSet(CFAllocatorRef const inAllocator)
+	: set( NULL )
+	, mSet( CFSetCreateMutable(inAllocator, 0, &kCFTypeSetCallBacks) )
+	, ownership( kQCOwnedUnique )
+	, allocator( inAllocator )
+	{ }
+	
+	// takes ownership, but the caller may still be holding on to inSet, so the first mutation copies it
 	explicit QCSet(CFMutableSetRef const inSet)
 	: set( NULL )
 	, mSet( inSet )
+	, ownership( kQCBorrowed )
+	, allocator( )
 	{ }
 	
 	explicit QCSet(CFSetRef const inSet)
 	: set( inSet )
 	, mSet( NULL )
+	, ownership( kQCOwnedUnique )
+	, allocator( )
 	{
 		Release(inSet);
 	}
@@ -44,8 +75,21 @@ public:
 	QCSet(QCSet const &inSet)
 	: set( Retain(inSet.set) )
 	, mSet( Retain(inSet.mSet) )
+	, ownership( inSet.share() )
+	, allocator( inSet.allocator )
 	{ }
 	
+	// move constructor -- steals inSet's references; inSet is left null
+	QCSet(QCSet &&inSet) noexcept
+	: set( inSet.set )
+	, mSet( inSet.mSet )
+	, ownership( inSet.ownership.load(std::memory_order_relaxed) )
+	, allocator( std::move(inSet.allocator) )
+	{
+		inSet.set = NULL;
+		inSet.mSet = NULL;
+	}
+	
 	// destructor
 	~QCSet( )
 	{
@@ -65,30 +109,33 @@ public:
 	
 	void makeMutable()
 	{
-		if (mSet != NULL)
+		if (mSet == NULL)
 		{
 			if (set != NULL)
 			{
-				mSet = CFSetCreateMutableCopy(kCFAllocatorDefault, 0, set);
+				mSet = CFSetCreateMutableCopy(CFGetAllocator(set), 0, set);
 				CFRelease(set);
 				set = NULL;
+				noteCopyOnWrite();
 			}
 			else
 			{
-				mSet = CFSetCreateMutable(kCFAllocatorDefault, 0, &kCFTypeSetCallBacks);
+				mSet = CFSetCreateMutable(allocator.get(), 0, &kCFTypeSetCallBacks);
 			}
-
+			ownership = kQCOwnedUnique;
 		}
 	}
 	
 	void makeUnique()
 	{
-		if (! null() && CFGetRetainCount(Set()) > 1)
+		// an immutable 'set' is copied by makeMutable; only a shared 'mSet' needs copying here
+		if (!isNull(mSet) && ownership != kQCOwnedUnique && !Detail::reclaimShared(ownership, mSet))
 		{
-			CFMutableSetRef newSet = CFSetCreateMutableCopy(kCFAllocatorDefault, 0, Set());
-			Release(Set());
-			set = NULL;
+			CFMutableSetRef newSet = CFSetCreateMutableCopy(CFGetAllocator(mSet), 0, mSet);
+			CFRelease(mSet);
 			mSet = newSet;
+			ownership = kQCOwnedUnique;
+			noteCopyOnWrite();
 		}
 	}
 	
@@ -113,13 +160,44 @@ public:
 		return Set();
 	}
 	
+	// copy assignment -- copy and swap
+	QCSet & operator = (QCSet const &rhs)
+	{
+		QCSet temp(rhs);
+		std::swap(set, temp.set);
+		std::swap(mSet, temp.mSet);
+		Detail::swapRelaxed(ownership, temp.ownership);
+		allocator.swap(temp.allocator);
+		return *this;
+	}
+	
+	// move assignment
+	QCSet & operator = (QCSet &&rhs) noexcept
+	{
+		std::swap(set, rhs.set);
+		std::swap(mSet, rhs.mSet);
+		Detail::swapRelaxed(ownership, rhs.ownership);
+		allocator.swap(rhs.allocator);
+		return *this;
+	}
+	
 	QCSet copy() const
 	{
 		return QCSet(*this);//null() ? QCSet() : QCSet(CFSetCreateMutableCopy(kCFAllocatorDefault, 0, set));
 	}
 	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this set null
+	CFSetRef take() &&
+	{
+		CFSetRef const s = Set();
+		mSet = NULL;
+		set = NULL;
+		return s;
+	}
+	
 	void add(CFTypeRef const &value)
 	{
+		makeMutable();
 		makeUnique();
 		CFSetAddValue(mSet, value);
 	}
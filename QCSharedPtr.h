@@ -16,6 +16,7 @@
 
 #include <CoreFoundation/CoreFoundation.h>
 
+#include <algorithm>
 #include <stdexcept>
 #include <tr1/memory>
 #include <tr1/type_traits>
@@ -46,6 +47,7 @@ namespace D
 	
 } /* anonymous namespace */
 
+// QCRef (QCRef.h) does the same job in one word, using the CF retain count instead of a control block.
 template < class T, bool = CFType_traits<T>::is_CFType >
 class QCSharedPtr;
 
@@ -146,6 +148,10 @@ private:
 	shared_ptr	_ptr;
 };
 
+/* CFProxy shares a CF object between owners using the object's own (atomic) retain count.
+ * It is exactly one pointer wide, needs no allocation of its own,
+ * and may be copied freely across threads.
+ */
 template<class T>
 class CFProxy
 {
@@ -153,31 +159,30 @@ static_assert(is_CFType<T>::value, "CFProxy is only compatible with Core Foundat
 private:
 	// data members
 	T obj;
-	CFIndex *proxyCount;
 	
 public:
 	// RAII ctor -- take ownership!
 	explicit CFProxy(T const ptr)
-	: obj(ptr), proxyCount(new CFIndex(1))
+	: obj(ptr)
 	{ }
 	
 	// copy ctor
 	CFProxy(CFProxy const &proxy)
-	: obj(proxy.obj), proxyCount(proxy.proxyCount)
+	: obj(Retain(proxy.obj))
+	{ }
+	
+	// move ctor -- the reference changes hands without touching the retain count
+	CFProxy(CFProxy &&proxy) noexcept
+	: obj(proxy.obj)
 	{
-		// could retain here and release in dtor regardless of proxyCount
-		++(*proxyCount);
+		proxy.obj = NULL;
 	}
 	
 	// dtor
 	~CFProxy()
 	{
-		// last one out turn off the lights and close & lock the door
-		if (--(*proxyCount) == 0)
-		{
-			Release(obj);
-			delete proxyCount;
-		}
+		// CF turns off the lights when the last reference goes
+		Release(obj);
 	}
 	
 	inline bool isNull() const
@@ -190,39 +195,37 @@ public:
 		return obj == NULL;
 	}
 	
+	// give up this proxy's reference early; the proxy becomes null
 	void release()
 	{
-		if ( --(*proxyCount) == 0)
-		{
-			Release(obj);
-			obj = NULL;
-		}
+		Release(obj);
+		obj = NULL;
+	}
+	
+	// adds a reference that the caller must balance with CFRelease
+	void retain() const
+	{
+		Retain(obj);
 	}
 	
-	void retain()
+	void swap(CFProxy &rhs) noexcept
 	{
-		++(*proxyCount);
+		std::swap(obj, rhs.obj);
 	}
 	
-	// copy assignment
+	// copy assignment -- copy and swap
 	CFProxy & operator = (CFProxy const &rhs)
 	{
-		// increment the reference count
-		rhs.retain();
-		
-		release();
-		if (*proxyCount == 0)
-		{
-			delete proxyCount;
-		}
-		
-		// TODO: switch to copy-and-swap ?
-		
-		// replace my count with rhs'.  We already called retain(), so don't increment the proxyCount (again).
-		proxyCount = rhs.proxyCount;
-		
-		// and finally, replace my obj with rhs'
-		obj = rhs.obj;
+		CFProxy temp(rhs);
+		swap(temp);
+		return *this;
+	}
+	
+	// move assignment -- our old reference leaves with rhs
+	CFProxy & operator = (CFProxy &&rhs) noexcept
+	{
+		swap(rhs);
+		return *this;
 	}
 	
 	// equality comparators
@@ -237,7 +240,7 @@ public:
 		return ! (*this == rhs);
 	}
 	
-	T get()
+	T get() const
 	{
 		return obj;
 	}
@@ -261,6 +264,8 @@ public:
 	
 };
 
+static_assert(sizeof(CFProxy<CFTypeRef>) == sizeof(CFTypeRef), "CFProxy must stay the size of one pointer.");
+
 END_QC_NAMESPACE
 
 #endif
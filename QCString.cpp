@@ -10,9 +10,45 @@
 #include "QCString.h"
 
 #include "QCData.h"
+#include "QCStringPool.h"
+
+#include <cstring>
 
 BEGIN_QC_NAMESPACE
 
+// static
+QCString QCString::interned(char const * const bytes, CFIndex const length)
+{
+	QCString result;
+	result.string = QCStringPool::shared().intern(bytes, length);
+	result.lifetime = isNull(result.string) ? kRefCounted : kInterned;
+	return result;
+}
+
+// static
+QCString QCString::interned(char const * const inString)
+{
+	QCString result;
+	result.string = QCStringPool::shared().intern(inString);
+	result.lifetime = isNull(result.string) ? kRefCounted : kInterned;
+	return result;
+}
+
+// static
+QCString QCString::interned(std::string const &inString)
+{
+	return interned(inString.data(), static_cast<CFIndex>(inString.size()));
+}
+
+// static
+QCString QCString::interned(CFStringRef const &inString)
+{
+	QCString result;
+	result.string = QCStringPool::shared().intern(inString);
+	result.lifetime = isNull(result.string) ? kRefCounted : kInterned;
+	return result;
+}
+
 char *QCString::CString() const
 {
 	return CString_malloc();
@@ -56,12 +92,114 @@ std::string QCString::StdString() const
 {
 	// not very efficient
 	char * const cString = CString_new();
+	if (cString == NULL) return std::string();
+	
 	std::string const stdStr(cString);
-	delete cString;
+	delete [] cString;
 	
 	return stdStr;
 }
 
+void QCString::appendTo(std::string &out) const
+{
+	CFStringRef const str = CFString();
+	if (isNull(str)) return;
+	
+	CFIndex const length = CFStringGetLength(str);
+	
+	// as in utf8(): a UTF-8 pointer means ASCII contents, so the byte count is the length, embedded NULs included
+	char const * const direct = CFStringGetCStringPtr(str, kCFStringEncodingUTF8);
+	if (direct != NULL)
+	{
+		out.append(direct, static_cast<size_t>(length));
+		return;
+	}
+	
+	size_t const oldSize = out.size();
+	
+	// optimistically assume ASCII, where a character is a byte: CF only narrows, no transcoding
+	out.resize(oldSize + static_cast<size_t>(length));
+	CFIndex asciiBytes = 0;
+	CFIndex const asciiCount = CFStringGetBytes(str, CFRangeMake(0, length), kCFStringEncodingASCII, 0, false
+												, reinterpret_cast<UInt8 *> (&out[oldSize]), length, &asciiBytes);
+	if (asciiCount == length)
+	{
+		return;
+	}
+	
+	// keep the ASCII prefix; measure the rest as UTF-8 and encode it into exactly that much room.
+	// As in operator <<, a lone surrogate becomes '?' rather than ending the conversion there.
+	CFRange const rest = CFRangeMake(asciiCount, length - asciiCount);
+	CFIndex restBytes = 0;
+	CFStringGetBytes(str, rest, kCFStringEncodingUTF8, '?', false, NULL, 0, &restBytes);
+	
+	size_t const restStart = oldSize + static_cast<size_t>(asciiBytes);
+	out.resize(restStart + static_cast<size_t>(restBytes));
+	CFStringGetBytes(str, rest, kCFStringEncodingUTF8, '?', false
+					 , reinterpret_cast<UInt8 *> (&out[restStart]), restBytes, NULL);
+}
+
+static_assert(sizeof(char16_t) == sizeof(UniChar), "std::u16string must hold UTF-16 units exactly.");
+
+std::u16string QCString::toU16String() const
+{
+	CFStringRef const str = CFString();
+	if (isNull(str)) return std::u16string();
+	
+	CFIndex const length = CFStringGetLength(str);
+	UniChar const * const direct = CFStringGetCharactersPtr(str);
+	if (direct != NULL)
+	{
+		return std::u16string(reinterpret_cast<char16_t const *> (direct), static_cast<size_t>(length));
+	}
+	
+	std::u16string result(static_cast<size_t>(length), u'\0');
+	if (length > 0)
+	{
+		CFStringGetCharacters(str, CFRangeMake(0, length), reinterpret_cast<UniChar *> (&result[0]));
+	}
+	return result;
+}
+
+QCUTF8View QCString::utf8(char * const buffer, CFIndex const capacity) const
+{
+	CFStringRef const str = CFString();
+	if (isNull(str)) return QCUTF8View();
+	
+	// CF hands out a UTF-8 pointer only for ASCII contents, so the byte count is the length;
+	// strlen would stop at an embedded NUL
+	char const * const direct = CFStringGetCStringPtr(str, kCFStringEncodingUTF8);
+	if (direct != NULL)
+	{
+		return QCUTF8View(direct, static_cast<size_t>(CFStringGetLength(str)));
+	}
+	
+	CFRange const all = CFRangeMake(0, CFStringGetLength(str));
+	CFIndex byteCount = 0;
+	
+	// try the caller's buffer first, leaving room for the NUL
+	if (buffer != NULL && capacity > 0)
+	{
+		CFIndex const converted = CFStringGetBytes(str, all, kCFStringEncodingUTF8, 0, false
+												   , reinterpret_cast<UInt8 *> (buffer), capacity - 1, &byteCount);
+		if (converted == all.length)
+		{
+			buffer[byteCount] = '\0';
+			return QCUTF8View(buffer, static_cast<size_t>(byteCount));
+		}
+	}
+	
+	// measure, then encode into exactly that many bytes
+	CFStringGetBytes(str, all, kCFStringEncodingUTF8, 0, false, NULL, 0, &byteCount);
+	
+	std::unique_ptr<char[]> bytes(new char[static_cast<size_t>(byteCount) + 1]);
+	CFStringGetBytes(str, all, kCFStringEncodingUTF8, 0, false
+					 , reinterpret_cast<UInt8 *> (bytes.get()), byteCount, NULL);
+	bytes[byteCount] = '\0';
+	
+	return QCUTF8View(std::move(bytes), static_cast<size_t>(byteCount));
+}
+
 void QCString::show() const
 {
 #ifndef NDEBUG
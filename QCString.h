@@ -15,11 +15,139 @@
 #include "CFRaiiCommon.h"
 #include <CoreServices/CoreServices.h>
 
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 BEGIN_QC_NAMESPACE
 
+namespace Detail
+{
+	// true if no byte has its high bit set; checks a machine word at a time
+	inline bool isASCII(char const * const bytes, size_t const count)
+	{
+		UInt64 const highBits = 0x8080808080808080ULL;
+		size_t i = 0;
+		
+		// memcpy is how to say "unaligned load" portably; compilers turn it into a single move
+		for ( ; i + 4 * sizeof(UInt64) <= count; i += 4 * sizeof(UInt64))
+		{
+			UInt64 words[4];
+			std::memcpy(words, bytes + i, sizeof(words));
+			if (((words[0] | words[1] | words[2] | words[3]) & highBits) != 0) return false;
+		}
+		for ( ; i + sizeof(UInt64) <= count; i += sizeof(UInt64))
+		{
+			UInt64 word;
+			std::memcpy(&word, bytes + i, sizeof(word));
+			if ((word & highBits) != 0) return false;
+		}
+		for ( ; i < count; ++i)
+		{
+			if (static_cast<unsigned char>(bytes[i]) >= 0x80) return false;
+		}
+		return true;
+	}
+	
+	// ASCII is stored by CF as-is; anything else has to be decoded (and validated) as UTF-8
+	inline CFStringEncoding encodingForUTF8Bytes(char const * const bytes, CFIndex const length)
+	{
+		return isASCII(bytes, static_cast<size_t>(length)) ? kCFStringEncodingASCII : kCFStringEncodingUTF8;
+	}
+}
+
+/* NUL-terminated UTF-8 bytes, as returned by QCString::utf8().
+ * Usually a view, like std::string_view, of bytes someone else owns, and valid only as long as they are;
+ * bytes that had to be encoded for the view are owned by it, and copied along with it.
+ */
+class QCUTF8View
+{
+private:
+	char const	*bytes;
+	size_t		count;
+	// non-NULL only when the view owns bytes; then bytes points into it
+	std::unique_ptr<char[]>	owned;
+	
+public:
+	typedef char const *	const_iterator;
+	
+	QCUTF8View()
+	: bytes( NULL )
+	, count( 0 )
+	, owned( )
+	{ }
+	
+	QCUTF8View(char const * const inBytes, size_t const inCount)
+	: bytes( inBytes )
+	, count( inCount )
+	, owned( )
+	{ }
+	
+	// takes inOwned, which holds inCount bytes and then a NUL
+	QCUTF8View(std::unique_ptr<char[]> inOwned, size_t const inCount)
+	: bytes( inOwned.get() )
+	, count( inCount )
+	, owned( std::move(inOwned) )
+	{ }
+	
+	// copy constructor -- owned bytes are copied, so each view keeps its own
+	QCUTF8View(QCUTF8View const &inView)
+	: bytes( inView.bytes )
+	, count( inView.count )
+	, owned( )
+	{
+		if (inView.owned)
+		{
+			owned.reset(new char[count + 1]);
+			std::memcpy(owned.get(), inView.bytes, count + 1);
+			bytes = owned.get();
+		}
+	}
+	
+	// move constructor -- owned bytes stay where they are, so bytes stays valid
+	QCUTF8View(QCUTF8View &&inView) noexcept
+	: bytes( inView.bytes )
+	, count( inView.count )
+	, owned( std::move(inView.owned) )
+	{
+		inView.bytes = NULL;
+		inView.count = 0;
+	}
+	
+	// copy and move assignment -- copy (or move) and swap
+	QCUTF8View & operator = (QCUTF8View rhs) noexcept
+	{
+		std::swap(bytes, rhs.bytes);
+		std::swap(count, rhs.count);
+		std::swap(owned, rhs.owned);
+		return *this;
+	}
+	
+	bool null() const				{ return bytes == NULL; }
+	bool empty() const				{ return count == 0; }
+	size_t size() const				{ return count; }
+	size_t length() const			{ return count; }
+	char const *data() const		{ return bytes; }
+	// NULL only for a null view
+	char const *c_str() const		{ return bytes; }
+	const_iterator begin() const	{ return bytes; }
+	const_iterator end() const		{ return bytes + count; }
+	char operator [] (size_t const i) const	{ return bytes[i]; }
+	
+	std::string str() const
+	{
+		return null() ? std::string() : std::string(bytes, count);
+	}
+};
+
 // this class is intended as an RAII wrapper for CFStringRefs
 class QCString
 {
@@ -27,35 +155,92 @@ private:
 	// class invariant: only one of string and mString may be non-NULL at a time
 	CFMutableStringRef	mString;
 	CFStringRef			string;
+	// who else can see mString; meaningless while mString is NULL
+	mutable std::atomic<QCOwnership>	ownership;
+	// CFHash of the contents, once computed; kept only while they are immutable (see hash())
+	mutable std::atomic<CFHashCode>	hashCode;
+	// whether we own a reference to 'string'
+	enum Lifetime
+	{
+		kRefCounted,	// we hold a reference to string, as usual
+		kImmortal,		// string is never deallocated (e.g. a CFSTR constant), so we neither retain nor release it
+		kInterned		// immortal, and also canonical: it came from QCStringPool
+	};
+	Lifetime			lifetime;
+	// what a string is created from while we hold none
+	Detail::HeldAllocator	allocator;
+	
+	// adopt a mutable string whose ownership we already know
+	QCString(CFMutableStringRef const &inString, QCOwnership const inOwnership)
+	: mString( inString )
+	, string( NULL )
+	, ownership( inOwnership )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( )
+	{ }
+	
+	// another wrapper is about to hold our mutable string; neither of us may append to it in place any more
+	QCOwnership share() const
+	{
+		if (isNotNull(mString))
+		{
+			// a borrowed reference stays borrowed, or reclaimShared could later hand the caller's object back to us
+			QCOwnership expected = kQCOwnedUnique;
+			ownership.compare_exchange_strong(expected, kQCShared, std::memory_order_relaxed);
+		}
+		return ownership.load(std::memory_order_relaxed);
+	}
+	
+	// let go of 'string', which we do not own if it is immortal
+	void dropString()
+	{
+		if (lifetime == kRefCounted)
+		{
+			Release(string);
+		}
+		string = NULL;
+		lifetime = kRefCounted;
+	}
 	
 	CFMutableStringRef CFMutableStringFromCFString(CFStringRef const &inString) const
 	{
 		CFMutableStringRef temp(NULL);
 		if (inString != NULL)
 		{
-			temp = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, inString);
+			temp = CFStringCreateMutableCopy(CFGetAllocator(inString), 0, inString);
 		}
 		return temp;
 	}
 	
-	CFStringRef CFStringFromCString(char const * const inString) const
+	CFStringRef CFStringFromCString(char const * const inString, CFAllocatorRef const allocator) const
+	{
+		return (inString == NULL) ? NULL : CFStringFromUTF8Bytes(inString, static_cast<CFIndex>(std::strlen(inString)), allocator);
+	}
+	
+	// NULL if bytes isn't valid UTF-8
+	CFStringRef CFStringFromUTF8Bytes(char const * const bytes, CFIndex const count, CFAllocatorRef const allocator) const
 	{
 		CFStringRef temp(NULL);
-		if (inString != NULL)
+		if (bytes != NULL && count >= 0)
 		{
-			temp = CFStringCreateWithCString(kCFAllocatorDefault, inString, kCFStringEncodingUTF8);
+			temp = CFStringCreateWithBytes(allocator
+										   , reinterpret_cast<UInt8 const *> (bytes)
+										   , count
+										   , Detail::encodingForUTF8Bytes(bytes, count)
+										   , false);
 		}
 		return temp;
 	}
 	
-	CFStringRef CFStringFromHFSUniStr255(HFSUniStr255 const &inString) const
+	CFStringRef CFStringFromHFSUniStr255(HFSUniStr255 const &inString, CFAllocatorRef const allocator) const
 	{
 		CFStringRef temp(NULL);
 		
 		// make sure the string has positive length
 		if (0 < inString.length)
 		{
-			temp = CFStringCreateWithCharacters(kCFAllocatorDefault, inString.unicode, inString.length);
+			temp = CFStringCreateWithCharacters(allocator, inString.unicode, inString.length);
 		}
 		
 		return temp;
@@ -65,46 +250,153 @@ public:
 	QCString( )
 	: string( NULL )
 	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( )
+	{ }
+	
+	// an empty string whose contents, any copies made to modify them, and any string created after this one is taken, come from allocator
+	explicit QCString(CFAllocatorRef const allocator)
+	: string( NULL )
+	, mString( CFStringCreateMutable(allocator, 0) )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
 	{ }
 	
+	// takes ownership, but the caller may still be holding on to inString, so the first append copies it
 	explicit QCString(CFMutableStringRef const &inString)
 	: string( NULL )
 	, mString( inString )
+	, ownership( kQCBorrowed )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( )
 	{ }
 	
 	explicit QCString(CFStringRef const &inString)
 	: string( inString )
 	, mString( NULL ) // maybe we'll never need it
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( )
 	{ }
 	
-	explicit QCString(HFSUniStr255 const &inString)
-	: string( CFStringFromHFSUniStr255(inString) )
+	explicit QCString(HFSUniStr255 const &inString, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: string( CFStringFromHFSUniStr255(inString, allocator) )
 	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
 //	: mString( CFMutableStringFromHFSUniStr255(inString) )
 	{ }
 	
 	// creating a CFString from a C-string
-	explicit QCString(char const * const inString)
-	: string( CFStringFromCString(inString) )
+	explicit QCString(char const * const inString, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: string( CFStringFromCString(inString, allocator) )
 	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
 	{ }
 	
-	explicit QCString(std::string const &inString)
-	: string( CFStringFromCString(inString.c_str()) )
+	/* UTF-8 of known length, which may contain NULs; no terminator is needed.
+	 * A named function rather than a constructor: QCString(s, NULL) and QCString(s, 0) would otherwise be ambiguous
+	 * between a byte count and an allocator.
+	 */
+	static QCString fromBytes(char const * const bytes, CFIndex const count, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	{
+		QCString result;
+		result.string = result.CFStringFromUTF8Bytes(bytes, count, allocator);
+		result.allocator = Detail::HeldAllocator(allocator);
+		return result;
+	}
+	
+	explicit QCString(std::string const &inString, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: string( CFStringFromUTF8Bytes(inString.data(), static_cast<CFIndex>(inString.size()), allocator) )
 	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
 	{ }
 	
+	explicit QCString(QCUTF8View const &inString, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: string( CFStringFromUTF8Bytes(inString.data(), static_cast<CFIndex>(inString.size()), allocator) )
+	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
+	{ }
+	
+#if __cplusplus >= 201703L
+	explicit QCString(std::string_view const &inString, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: string( CFStringFromUTF8Bytes(inString.data(), static_cast<CFIndex>(inString.size()), allocator) )
+	, mString( NULL )
+	, ownership( kQCOwnedUnique )
+	, hashCode( 0 )
+	, lifetime( kRefCounted )
+	, allocator( allocator )
+	{ }
+#endif
+	
+	/* Wraps UTF-8 bytes without copying them when they are ASCII, which CF can use as they are;
+	 * other text is decoded and the bytes released straight away.
+	 * Either way contentsDeallocator frees bytes when CF is done with them:
+	 * pass kCFAllocatorNull for bytes that outlive the string, kCFAllocatorMalloc for malloc'd bytes.
+	 */
+	static QCString withBytesNoCopy(char const * const bytes, CFIndex const count
+									, CFAllocatorRef const contentsDeallocator
+									, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	{
+		if (bytes == NULL || count < 0)
+		{
+			return QCString();
+		}
+		return QCString(CFStringCreateWithBytesNoCopy(allocator
+													  , reinterpret_cast<UInt8 const *> (bytes)
+													  , count
+													  , Detail::encodingForUTF8Bytes(bytes, count)
+													  , false
+													  , contentsDeallocator));
+	}
+	
 	
 	// copy constructor
 	QCString(QCString const &inString)
-	: string( Retain(inString.string) )
+	: string( inString.lifetime != kRefCounted ? inString.string : Retain(inString.string) )
 	, mString( Retain(inString.mString) )
+	, ownership( inString.share() )
+	, hashCode( inString.hashCode.load(std::memory_order_relaxed) )
+	, lifetime( inString.lifetime )
+	, allocator( inString.allocator )
 	{ }
 	
+	// move constructor -- steals inString's references, so no retain / release traffic
+	QCString(QCString &&inString) noexcept
+	: string( inString.string )
+	, mString( inString.mString )
+	, ownership( inString.ownership.load(std::memory_order_relaxed) )
+	, hashCode( inString.hashCode.load(std::memory_order_relaxed) )
+	, lifetime( inString.lifetime )
+	, allocator( std::move(inString.allocator) )
+	{
+		inString.string = NULL;
+		inString.mString = NULL;
+		inString.hashCode.store(0, std::memory_order_relaxed);
+		inString.lifetime = kRefCounted;
+	}
+	
 	// destructor
 	~QCString()
 	{
-		Release(string);
+		dropString();
 		Release(mString);
 	}
 	
@@ -127,16 +419,23 @@ public:
 		
 		if (!isNull(mString))
 		{
-			// relinquish our ownership
-			CFMutableStringRef newString = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, mString);
-			CFRelease(mString);
-			mString = newString;
+			// a string only we can see is appended to in place
+			if (ownership != kQCOwnedUnique && !Detail::reclaimShared(ownership, mString))
+			{
+				// relinquish our ownership
+				CFMutableStringRef newString = CFStringCreateMutableCopy(CFGetAllocator(mString), 0, mString);
+				CFRelease(mString);
+				mString = newString;
+				ownership = kQCOwnedUnique;
+				noteCopyOnWrite();
+			}
 		}
 		else if (!isNull(string))
 		{
-			mString = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, string);
-			CFRelease(string);
-			string = NULL;
+			mString = CFStringCreateMutableCopy(CFGetAllocator(string), 0, string);
+			dropString();
+			ownership = kQCOwnedUnique;
+			noteCopyOnWrite();
 		}
 	}
 	
@@ -145,6 +444,19 @@ public:
 		return isNull(mString) && isNull(string);
 	}
 	
+	// CFHash of the contents; memoized while they are immutable, recomputed while they may still change
+	CFHashCode hash() const
+	{
+		// relaxed is enough: any thread that computes the hash computes the same value
+		CFHashCode const cached = hashCode.load(std::memory_order_relaxed);
+		if (cached != 0 && isNull(mString)) return cached;
+		
+		CFTypeRef const ref = CFString();
+		CFHashCode const h = isNull(ref) ? 0 : CFHash(ref);
+		if (isNull(mString)) hashCode.store(h, std::memory_order_relaxed);
+		return h;
+	}
+	
 	CFIndex length() const
 	{
 		CFStringRef str = CFString();
@@ -155,14 +467,322 @@ public:
 	QCString copy() const
 	{
 		CFStringRef str = CFString();
-		return QCString(CFStringCreateMutableCopy(CFGetAllocator(str), 0, str));
+		return QCString(CFStringCreateMutableCopy(CFGetAllocator(str), 0, str), kQCOwnedUnique);
+	}
+	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this string null
+	CFStringRef take() &&
+	{
+		CFStringRef const str = isNotNull(mString) ? mString : string;
+		if (lifetime != kRefCounted)
+		{
+			// the caller gets a reference of its own; ours was never counted
+			CFRetain(str);
+		}
+		mString = NULL;
+		string = NULL;
+		hashCode.store(0, std::memory_order_relaxed);
+		lifetime = kRefCounted;
+		return str;
+	}
+	
+	// canonical strings from QCStringPool; two interned strings are equal exactly when they are the same object
+	static QCString interned(char const * const bytes, CFIndex const length);
+	static QCString interned(char const * const inString);
+	static QCString interned(std::string const &inString);
+	static QCString interned(CFStringRef const &inString);
+	
+	bool isInterned() const
+	{
+		return lifetime == kInterned;
+	}
+	
+	/* Wraps a string that is never deallocated -- a CFSTR constant, or one deliberately leaked --
+	 * without retaining it, so copies and destruction of the result cost nothing. See QC_STR.
+	 */
+	static QCString immortal(CFStringRef const &constant)
+	{
+		QCString result;
+		result.string = constant;
+		result.lifetime = isNull(constant) ? kRefCounted : kImmortal;
+		return result;
 	}
 	
+	// one CF call per character; prefer iterators for scanning
 	UniChar at(CFIndex const idx) const
 	{
 		return CFStringGetCharacterAtIndex(CFString(), idx);
 	}
 	
+	// MARK: class const_iterator
+	// Random access over UTF-16 units, read through a CFStringInlineBuffer:
+	// most dereferences are an index into a local array or into the string's own storage.
+	// That buffer lives in the iterator (about 180 bytes on 64-bit, 64 of them UTF-16 units), so every copy copies it:
+	// cheap for a loop, but algorithms that pass iterators around by value, like std::sort, pay it on every copy.
+	// Like any view, an iterator is invalidated by modifying or destroying the string.
+	class const_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag	iterator_category;
+		typedef UniChar							value_type;
+		typedef CFIndex							difference_type;
+		typedef UniChar const *					pointer;
+		typedef UniChar							reference; // characters are returned by value
+		
+	private:
+		CFStringRef						str;
+		CFIndex							index;
+		// refilled as we move around, hence mutable
+		mutable CFStringInlineBuffer	buffer;
+		
+	public:
+		const_iterator()
+		: str( NULL )
+		, index( 0 )
+		{ }
+		
+		const_iterator(CFStringRef const inString, CFIndex const idx)
+		: str( inString )
+		, index( idx )
+		{
+			if (isNotNull(str))
+			{
+				CFStringInitInlineBuffer(str, &buffer, CFRangeMake(0, CFStringGetLength(str)));
+			}
+		}
+		
+		CFIndex position() const
+		{
+			return index;
+		}
+		
+		// dereference operators
+		UniChar operator * () const
+		{
+			return CFStringGetCharacterFromInlineBuffer(&buffer, index);
+		}
+		
+		UniChar operator [] (CFIndex const n) const
+		{
+			return CFStringGetCharacterFromInlineBuffer(&buffer, index + n);
+		}
+		
+		// prefix operators (must return by reference)
+		const_iterator & operator ++ ()
+		{
+			++ index;
+			return *this;
+		}
+		
+		const_iterator & operator -- ()
+		{
+			-- index;
+			return *this;
+		}
+		
+		// postfix operators (must not return by reference)
+		const_iterator operator ++ (int)
+		{
+			const_iterator temp(*this);
+			this -> operator ++();
+			return temp;
+		}
+		
+		const_iterator operator -- (int)
+		{
+			const_iterator temp(*this);
+			this -> operator --();
+			return temp;
+		}
+		
+		// arithmetic
+		const_iterator & operator += (CFIndex const n)
+		{
+			index += n;
+			return *this;
+		}
+		
+		const_iterator & operator -= (CFIndex const n)
+		{
+			index -= n;
+			return *this;
+		}
+		
+		const_iterator operator + (CFIndex const n) const
+		{
+			const_iterator temp(*this);
+			return temp += n;
+		}
+		
+		const_iterator operator - (CFIndex const n) const
+		{
+			const_iterator temp(*this);
+			return temp -= n;
+		}
+		
+		CFIndex operator - (const_iterator const &rhs) const
+		{
+			return index - rhs.index;
+		}
+		
+		friend const_iterator operator + (CFIndex const n, const_iterator const &rhs)
+		{
+			return rhs + n;
+		}
+		
+		// comparison operators
+		bool operator == (const_iterator const &rhs) const
+		{
+			return str == rhs.str && index == rhs.index;
+		}
+		
+		bool operator != (const_iterator const &rhs) const
+		{
+			return !(*this == rhs);
+		}
+		
+		bool operator < (const_iterator const &rhs) const	{ return index < rhs.index; }
+		bool operator > (const_iterator const &rhs) const	{ return index > rhs.index; }
+		bool operator <= (const_iterator const &rhs) const	{ return index <= rhs.index; }
+		bool operator >= (const_iterator const &rhs) const	{ return index >= rhs.index; }
+	}; // class const_iterator
+	
+	const_iterator begin() const
+	{
+		return const_iterator(CFString(), 0);
+	}
+	
+	const_iterator end() const
+	{
+		return const_iterator(CFString(), length());
+	}
+	
+	// MARK: class code_point_iterator
+	// Bidirectional iteration over Unicode code points: surrogate pairs are combined,
+	// and an unpaired surrogate is returned as it is.
+	class code_point_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag	iterator_category;
+		typedef UTF32Char						value_type;
+		typedef CFIndex							difference_type;
+		typedef UTF32Char const *				pointer;
+		typedef UTF32Char						reference;
+		
+	private:
+		const_iterator	units;
+		CFIndex			count;
+		
+		UniChar unitAt(CFIndex const idx) const
+		{
+			return units[idx - units.position()];
+		}
+		
+	public:
+		code_point_iterator()
+		: units( )
+		, count( 0 )
+		{ }
+		
+		code_point_iterator(CFStringRef const inString, CFIndex const idx)
+		: units( inString, idx )
+		, count( isNull(inString) ? 0 : CFStringGetLength(inString) )
+		{ }
+		
+		// index of the current code point's first UTF-16 unit
+		CFIndex position() const
+		{
+			return units.position();
+		}
+		
+		UTF32Char operator * () const
+		{
+			CFIndex const idx = units.position();
+			UniChar const first = *units;
+			if (CFStringIsSurrogateHighCharacter(first) && idx + 1 < count)
+			{
+				UniChar const second = unitAt(idx + 1);
+				if (CFStringIsSurrogateLowCharacter(second))
+				{
+					return CFStringGetLongCharacterForSurrogatePair(first, second);
+				}
+			}
+			return first;
+		}
+		
+		code_point_iterator & operator ++ ()
+		{
+			CFIndex const idx = units.position();
+			++ units;
+			if (CFStringIsSurrogateHighCharacter(unitAt(idx))
+				&& idx + 1 < count
+				&& CFStringIsSurrogateLowCharacter(unitAt(idx + 1)))
+			{
+				++ units;
+			}
+			return *this;
+		}
+		
+		code_point_iterator & operator -- ()
+		{
+			-- units;
+			CFIndex const idx = units.position();
+			if (idx > 0
+				&& CFStringIsSurrogateLowCharacter(unitAt(idx))
+				&& CFStringIsSurrogateHighCharacter(unitAt(idx - 1)))
+			{
+				-- units;
+			}
+			return *this;
+		}
+		
+		code_point_iterator operator ++ (int)
+		{
+			code_point_iterator temp(*this);
+			this -> operator ++();
+			return temp;
+		}
+		
+		code_point_iterator operator -- (int)
+		{
+			code_point_iterator temp(*this);
+			this -> operator --();
+			return temp;
+		}
+		
+		bool operator == (code_point_iterator const &rhs) const
+		{
+			return units == rhs.units;
+		}
+		
+		bool operator != (code_point_iterator const &rhs) const
+		{
+			return !(*this == rhs);
+		}
+	}; // class code_point_iterator
+	
+	// for (UTF32Char c : str.codePoints())
+	class code_point_range
+	{
+	private:
+		CFStringRef	str;
+		CFIndex		count;
+		
+	public:
+		code_point_range(CFStringRef const inString, CFIndex const inCount)
+		: str( inString )
+		, count( inCount )
+		{ }
+		
+		code_point_iterator begin() const	{ return code_point_iterator(str, 0); }
+		code_point_iterator end() const		{ return code_point_iterator(str, count); }
+	};
+	
+	code_point_range codePoints() const
+	{
+		return code_point_range(CFString(), length());
+	}
+	
 	// Operators
 	
 	// copy assignment -- copy and swap
@@ -171,6 +791,22 @@ public:
 		QCString temp(rhs);
 		std::swap(mString, temp.mString);
 		std::swap(string, temp.string);
+		Detail::swapRelaxed(ownership, temp.ownership);
+		Detail::swapRelaxed(hashCode, temp.hashCode);
+		std::swap(lifetime, temp.lifetime);
+		allocator.swap(temp.allocator);
+		return *this;
+	}
+	
+	// move assignment -- our old references leave with rhs
+	QCString & operator = (QCString &&rhs) noexcept
+	{
+		std::swap(mString, rhs.mString);
+		std::swap(string, rhs.string);
+		Detail::swapRelaxed(ownership, rhs.ownership);
+		Detail::swapRelaxed(hashCode, rhs.hashCode);
+		std::swap(lifetime, rhs.lifetime);
+		allocator.swap(rhs.allocator);
 		return *this;
 	}
 	
@@ -178,7 +814,8 @@ public:
 	bool operator == (QCString const &rhs) const
 	{
 		return (CFString() == rhs.CFString()) // optimization
-				|| (CFStringCompare(CFString(), rhs.CFString(), 0) == kCFCompareEqualTo);
+				|| (!(lifetime == kInterned && rhs.lifetime == kInterned) // distinct interned strings always differ
+					&& CFStringCompare(CFString(), rhs.CFString(), 0) == kCFCompareEqualTo);
 	}
 	
 	bool operator != (QCString const &rhs) const
@@ -209,6 +846,10 @@ public:
 	// concatenate operator
 	QCString & operator += (QCString const &rhs)
 	{
+		if (rhs.null())
+		{
+			return *this;
+		}
 //		makeMutable();
 		makeUnique();
 //		return (*this += rhs.string); // would this work?
@@ -216,7 +857,8 @@ public:
 		if (isNull(mString))
 		{
 			// this case is possible only if string and mString were both NULL before calling makeUnique
-			mString = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, rhs.CFString());
+			mString = CFStringCreateMutableCopy(allocator.get(), 0, rhs.CFString());
+			ownership = kQCOwnedUnique;
 		}
 		else
 		{
@@ -234,6 +876,7 @@ public:
 			if (isNull(mString))
 			{
 				mString = Retain(rhs);
+				ownership = kQCBorrowed;
 			}
 			else
 			{
@@ -252,7 +895,8 @@ public:
 			
 			if (isNull(mString))
 			{
-				mString = CFMutableStringFromCFString(rhs);
+				mString = CFStringCreateMutableCopy(allocator.get(), 0, rhs);
+				ownership = kQCOwnedUnique;
 			}
 			else
 			{
@@ -264,9 +908,19 @@ public:
 	
 	QCString & operator += (char const *rhs)
 	{
-		makeUnique();
-		
-		return (rhs == NULL) ? *this : *this += QCString(rhs);
+		if (rhs != NULL)
+		{
+			makeUnique();
+			
+			if (isNull(mString))
+			{
+				mString = CFStringCreateMutable(allocator.get(), 0);
+				ownership = kQCOwnedUnique;
+			}
+			// no intermediate CFString
+			CFStringAppendCString(mString, rhs, kCFStringEncodingUTF8);
+		}
+		return *this;
 	}
 	
 	bool hasPrefix(CFStringRef const &prefix) const
@@ -324,14 +978,14 @@ public:
 		}
 		
 		CFRange range = CFRangeMake(startPos, endPos - startPos + 1); // + 1 to compensate for 0-indexing
-		CFStringRef temp = CFStringCreateWithSubstring(kCFAllocatorDefault, CFString(), range);
+		CFStringRef temp = CFStringCreateWithSubstring(CFGetAllocator(CFString()), CFString(), range);
 		
 		return QCString(temp); // takes ownership & releases when done
 	}
 	
 	QCString substring(CFRange range) const
 	{
-		return QCString( CFStringCreateWithSubstring(kCFAllocatorDefault, CFString(), range) );
+		return QCString( CFStringCreateWithSubstring(CFGetAllocator(CFString()), CFString(), range) );
 //		return substring(range.location, range.location + range.length);
 		/* more readable form: 
 		CFIndex startPos = range.location;
@@ -350,8 +1004,13 @@ public:
 		{
 			return kCFNotFound;
 		}
-		CFIndex location = (CFStringFind(CFString(), searchString, 0)).location + range.location;
-		return location;
+		// search only within range; the result is an index into the whole string
+		CFRange found;
+		if (!CFStringFindWithOptions(CFString(), searchString, range, 0, &found))
+		{
+			return kCFNotFound;
+		}
+		return found.location;
 	}
 	
 	CFIndex stringIndex(CFStringRef const &searchString, CFIndex const startPos, CFIndex const endPos) const
@@ -359,6 +1018,46 @@ public:
 		return stringIndex(searchString, CFRangeMake(startPos, endPos - startPos));
 	}
 	
+	// every non-overlapping occurrence, in order; options as for CFStringFindWithOptions (except kCFCompareBackwards)
+	std::vector<CFRange> findAll(CFStringRef const &searchString, CFOptionFlags const options = 0) const
+	{
+		std::vector<CFRange> found;
+		CFIndex const lengthCache = length();
+		if (null() || isNull(searchString) || CFStringGetLength(searchString) == 0)
+		{
+			return found;
+		}
+		
+		CFRange match;
+		CFIndex location = 0;
+		while (location < lengthCache
+			   && CFStringFindWithOptions(CFString(), searchString, CFRangeMake(location, lengthCache - location), options, &match))
+		{
+			found.push_back(match);
+			location = match.location + std::max<CFIndex>(match.length, 1);
+		}
+		return found;
+	}
+	
+	// replaces every occurrence in place and returns how many there were
+	CFIndex replaceAll(CFStringRef const &searchString, CFStringRef const &replacement, CFOptionFlags const options = 0)
+	{
+		if (null() || isNull(searchString) || isNull(replacement))
+		{
+			return 0;
+		}
+		
+		// don't copy-on-write a string that has nothing to replace
+		CFRange found;
+		if (!CFStringFindWithOptions(CFString(), searchString, CFRangeMake(0, length()), options, &found))
+		{
+			return 0;
+		}
+		
+		makeUnique();
+		return CFStringFindAndReplace(mString, searchString, replacement, CFRangeMake(0, length()), options);
+	}
+	
 	CFIndex charIndex(char const c, CFIndex const startPos, CFIndex const endPos) const
 	{
 		CFIndex const lengthCache = length();
@@ -373,10 +1072,20 @@ public:
 		{
 			return kCFNotFound;
 		}
-		// create c string from char
-		char str[2] = {c, '\0'};
+		// scan [startPos, endPos] in place rather than building a substring and a one-character string to find
+		CFRange const range = CFRangeMake(startPos, std::min(endPos - startPos + 1, lengthCache - startPos));
+		UniChar const target = static_cast<unsigned char> (c);
 		
-		return CFStringFind(substring(startPos, endPos), QCString(str), 0).location + startPos;
+		CFStringInlineBuffer buffer;
+		CFStringInitInlineBuffer(CFString(), &buffer, range);
+		for (CFIndex i = 0; i < range.length; ++i)
+		{
+			if (CFStringGetCharacterFromInlineBuffer(&buffer, i) == target)
+			{
+				return i + startPos;
+			}
+		}
+		return kCFNotFound;
 	}
 	
 	// returns a C-string that requires free()ing
@@ -385,8 +1094,35 @@ public:
 	// returns a C-string that requires delete-ing
 	char *CString_new() const;
 	
+	// the file-system representation (decomposed UTF-8), as for a path; see toStdString() for general text
 	std::string StdString() const;
 	
+	// UTF-8, sized exactly and written straight into the destination
+	std::string toStdString() const
+	{
+		std::string result;
+		appendTo(result);
+		return result;
+	}
+	void appendTo(std::string &out) const;
+	
+	std::u16string toU16String() const;
+	
+	/* UTF-8 without copying when CF can hand out its own buffer (CFStringGetCStringPtr);
+	 * that view is invalidated by modifying or destroying this string.
+	 * Otherwise the string is encoded into 'buffer' if it fits, or else into bytes allocated for, and owned by, the view.
+	 */
+	QCUTF8View utf8() const
+	{
+		return utf8(NULL, 0);
+	}
+	QCUTF8View utf8(char * const buffer, CFIndex const capacity) const;
+	template < size_t N >
+	QCUTF8View utf8(char (&buffer)[N]) const
+	{
+		return utf8(buffer, static_cast<CFIndex>(N));
+	}
+	
 	void show() const;
 	
 	bool writeToFile(QCString const &filePath) const;
@@ -422,30 +1158,85 @@ inline QCString operator + (QCString const &lhs, char const *rhs)
 	return temp;
 }
 
+// an expiring left-hand side is appended to in place, so a + b + c + ... stays linear
+inline QCString operator + (QCString &&lhs, QCString const &rhs)
+{
+	lhs += rhs;
+	return std::move(lhs);
+}
+
+inline QCString operator + (QCString &&lhs, CFMutableStringRef const &rhs)
+{
+	lhs += rhs;
+	return std::move(lhs);
+}
+
+inline QCString operator + (QCString &&lhs, CFStringRef const &rhs)
+{
+	lhs += rhs;
+	return std::move(lhs);
+}
+
+inline QCString operator + (QCString &&lhs, char const *rhs)
+{
+	lhs += rhs;
+	return std::move(lhs);
+}
+
 template <class OStream>
 OStream & operator << (OStream & os, QCString const &str)
 {
-	char const *c_str = CFStringGetCStringPtr(str.CFString(), kCFStringEncodingUTF8);
-	if (c_str == NULL)
+	CFStringRef const cfStr = str.CFString();
+	if (isNull(cfStr)) return os;
+	
+	char const * const c_str = CFStringGetCStringPtr(cfStr, kCFStringEncodingUTF8);
+	if (c_str != NULL)
 	{
-		c_str = str.CString_new();
-		if (c_str != NULL)
-		{
-			os << c_str;
-			delete c_str;
-		}
-		
-		return os;
+		// we got a pointer to the string's internal c-string; no cleanup here.
+		return os << c_str;
 	}
-	else
+	
+	// encode a chunk at a time into the stack, so memory use doesn't depend on the string's length
+	char buffer[1024];
+	CFIndex const length = CFStringGetLength(cfStr);
+	CFIndex location = 0;
+	
+	while (location < length)
 	{
-		// we got a pointer to String()'s internal c-string; no cleanup here.
-		return os << c_str;
+		CFIndex used = 0;
+		// CF stops before a character (or surrogate pair) that would not fit;
+		// unencodable lone surrogates become '?' rather than stalling the loop
+		CFIndex const converted = CFStringGetBytes(cfStr, CFRangeMake(location, length - location)
+												   , kCFStringEncodingUTF8, '?', false
+												   , reinterpret_cast<UInt8 *> (buffer), sizeof(buffer), &used);
+		if (converted <= 0) break;
+		
+		os.write(buffer, used);
+		location += converted;
 	}
+	
+	return os;
 }
 
 typedef QCString const QCFixedString;
 
+/* QC_STR("key") is a QCString for a string literal with no allocation and no reference counting:
+ * the CFString is the compiler's CFSTR constant, made once per literal, and it is wrapped as immortal.
+ * The literal must be ASCII, as for CFSTR.
+ */
+#define QC_STR(literal) QC::QCString::immortal(CFSTR(literal))
+
+namespace literals
+{
+	// "key"_qcs -- for literals that aren't CFSTR-compatible; each use is a lookup in QCStringPool
+	inline QCString operator""_qcs(char const * const bytes, size_t const length)
+	{
+		return QCString::interned(bytes, static_cast<CFIndex>(length));
+	}
+}
+
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCString, CFStringRef)
+
 #endif
@@ -0,0 +1,136 @@
+/*
+ *  QCStringBuilder.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Accumulates UTF-16 in a growable buffer and creates a single CFString at the end.
+ * Use this instead of repeated QCString += when assembling a string from many pieces.
+ */
+
+#ifndef _QC_STRING_BUILDER_GUARD_
+#define _QC_STRING_BUILDER_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <vector>
+#include "CFRaiiCommon.h"
+
+#include "QCString.h"
+
+BEGIN_QC_NAMESPACE
+
+class QCStringBuilder
+{
+private:
+	std::vector<UniChar>	buffer;
+
+	// grow by count characters and return a pointer to the first new one
+	UniChar *extend(CFIndex const count)
+	{
+		size_t const oldSize = buffer.size();
+		buffer.resize(oldSize + static_cast<size_t>(count));
+		return &buffer[oldSize];
+	}
+
+public:
+	// capacityHint is in UTF-16 units; it is only a hint, the builder grows past it as needed
+	explicit QCStringBuilder(CFIndex const capacityHint = 0)
+	: buffer( )
+	{
+		reserve(capacityHint);
+	}
+
+	void reserve(CFIndex const capacity)
+	{
+		if (capacity > 0)
+		{
+			buffer.reserve(static_cast<size_t>(capacity));
+		}
+	}
+
+	CFIndex length() const
+	{
+		return static_cast<CFIndex>(buffer.size());
+	}
+
+	bool empty() const
+	{
+		return buffer.empty();
+	}
+
+	void clear()
+	{
+		buffer.clear();
+	}
+
+	QCStringBuilder & append(UniChar const c)
+	{
+		buffer.push_back(c);
+		return *this;
+	}
+
+	QCStringBuilder & append(UniChar const * const chars, CFIndex const count)
+	{
+		if (chars != NULL && count > 0)
+		{
+			std::copy(chars, chars + count, extend(count));
+		}
+		return *this;
+	}
+
+	QCStringBuilder & append(CFStringRef const &str)
+	{
+		CFIndex const count = isNull(str) ? 0 : CFStringGetLength(str);
+		if (count > 0)
+		{
+			CFStringGetCharacters(str, CFRangeMake(0, count), extend(count));
+		}
+		return *this;
+	}
+
+	QCStringBuilder & append(QCString const &str)
+	{
+		return append(str.CFString());
+	}
+
+	// UTF-8; ASCII is widened in place, anything else goes through CF
+	QCStringBuilder & append(char const *str)
+	{
+		if (str == NULL)
+		{
+			return *this;
+		}
+
+		for ( ; *str != '\0'; ++str)
+		{
+			if (static_cast<unsigned char>(*str) >= 0x80)
+			{
+				QCString const rest(str);
+				return append(rest);
+			}
+			buffer.push_back(static_cast<UniChar>(*str));
+		}
+		return *this;
+	}
+
+	template < class T >
+	QCStringBuilder & operator += (T const &rhs)
+	{
+		return append(rhs);
+	}
+
+	// creates the string; the builder keeps its contents and may be appended to further
+	QCString build(CFAllocatorRef const allocator = kCFAllocatorDefault) const
+	{
+		return QCString(CFStringCreateWithCharacters(allocator
+													 , empty() ? NULL : &buffer[0]
+													 , length()));
+	}
+};
+
+END_QC_NAMESPACE
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ *  QCStringCompare.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCStringCompare.h"
+
+#include <algorithm>
+#include <cstring>
+
+BEGIN_QC_NAMESPACE
+
+namespace
+{
+	inline CFComparisonResult compareLengths(CFIndex const lhs, CFIndex const rhs)
+	{
+		if (lhs == rhs) return kCFCompareEqualTo;
+		return (lhs < rhs) ? kCFCompareLessThan : kCFCompareGreaterThan;
+	}
+
+	template < class L, class R >
+	CFComparisonResult compareUnits(L const *lhs, CFIndex const lhsLength, R const *rhs, CFIndex const rhsLength)
+	{
+		CFIndex const common = std::min(lhsLength, rhsLength);
+		for (CFIndex i = 0; i < common; ++i)
+		{
+			UniChar const l = static_cast<UniChar>(lhs[i]);
+			UniChar const r = static_cast<UniChar>(rhs[i]);
+			if (l != r)
+			{
+				return (l < r) ? kCFCompareLessThan : kCFCompareGreaterThan;
+			}
+		}
+		return compareLengths(lhsLength, rhsLength);
+	}
+
+	// [0, length) of str, appended to units
+	void appendCharacters(CFStringRef const str, std::vector<UniChar> &units)
+	{
+		CFIndex const length = CFStringGetLength(str);
+		if (length == 0) return;
+
+		size_t const oldSize = units.size();
+		units.resize(oldSize + static_cast<size_t>(length));
+		CFStringGetCharacters(str, CFRangeMake(0, length), &units[oldSize]);
+	}
+}
+
+// MARK: -
+// MARK: QCStringOrdinalLess
+
+// static
+CFComparisonResult QCStringOrdinalLess::compare(CFStringRef const lhs, CFStringRef const rhs)
+{
+	if (lhs == rhs) return kCFCompareEqualTo;
+	if (isNull(lhs)) return kCFCompareLessThan;
+	if (isNull(rhs)) return kCFCompareGreaterThan;
+
+	CFIndex const lhsLength = CFStringGetLength(lhs);
+	CFIndex const rhsLength = CFStringGetLength(rhs);
+
+	// CF only hands out an ASCII pointer for a string that is ASCII, where bytes and UTF-16 units order alike
+	char const * const lhsASCII = CFStringGetCStringPtr(lhs, kCFStringEncodingASCII);
+	char const * const rhsASCII = CFStringGetCStringPtr(rhs, kCFStringEncodingASCII);
+	if (lhsASCII != NULL && rhsASCII != NULL)
+	{
+		int const result = std::memcmp(lhsASCII, rhsASCII, static_cast<size_t>(std::min(lhsLength, rhsLength)));
+		if (result != 0) return (result < 0) ? kCFCompareLessThan : kCFCompareGreaterThan;
+		return compareLengths(lhsLength, rhsLength);
+	}
+
+	// UTF-16 can't be memcmp'd (byte order), but comparing the units in place is the next best thing
+	UniChar const * const lhsUnits = CFStringGetCharactersPtr(lhs);
+	UniChar const * const rhsUnits = CFStringGetCharactersPtr(rhs);
+	if (lhsUnits != NULL && rhsUnits != NULL)
+	{
+		return compareUnits(lhsUnits, lhsLength, rhsUnits, rhsLength);
+	}
+	if (lhsASCII != NULL && rhsUnits != NULL)
+	{
+		return compareUnits(reinterpret_cast<unsigned char const *> (lhsASCII), lhsLength, rhsUnits, rhsLength);
+	}
+	if (lhsUnits != NULL && rhsASCII != NULL)
+	{
+		return compareUnits(lhsUnits, lhsLength, reinterpret_cast<unsigned char const *> (rhsASCII), rhsLength);
+	}
+
+	// no direct access to at least one of them
+	CFIndex const common = std::min(lhsLength, rhsLength);
+	CFStringInlineBuffer lhsBuffer, rhsBuffer;
+	CFStringInitInlineBuffer(lhs, &lhsBuffer, CFRangeMake(0, lhsLength));
+	CFStringInitInlineBuffer(rhs, &rhsBuffer, CFRangeMake(0, rhsLength));
+
+	for (CFIndex i = 0; i < common; ++i)
+	{
+		UniChar const l = CFStringGetCharacterFromInlineBuffer(&lhsBuffer, i);
+		UniChar const r = CFStringGetCharacterFromInlineBuffer(&rhsBuffer, i);
+		if (l != r)
+		{
+			return (l < r) ? kCFCompareLessThan : kCFCompareGreaterThan;
+		}
+	}
+	return compareLengths(lhsLength, rhsLength);
+}
+
+// static
+CFComparisonResult QCStringOrdinalLess::compareValues(void const *lhs, void const *rhs, void *)
+{
+	return compare(static_cast<CFStringRef> (lhs), static_cast<CFStringRef> (rhs));
+}
+
+// MARK: -
+// MARK: QCCollationKey
+
+QCCollationKey::QCCollationKey(QCString const &str, CFLocaleRef const locale)
+: source( str )
+, key( )
+{
+	CFStringRef const original = str.CFString();
+	if (isNull(original))
+	{
+		return;
+	}
+
+	CFMutableStringRef const folded = CFStringCreateMutableCopy(kCFAllocatorDefault, 0, original);
+	if (folded == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	CFStringNormalize(folded, kCFStringNormalizationFormKD);
+	CFStringFold(folded, kCFCompareCaseInsensitive | kCFCompareDiacriticInsensitive | kCFCompareWidthInsensitive, locale);
+
+	key.reserve(static_cast<size_t>(CFStringGetLength(folded) + 1 + CFStringGetLength(original)));
+	appendCharacters(folded, key);
+	key.push_back(0); // so a folded prefix sorts first, whatever follows the tie-breaker
+	appendCharacters(original, key);
+
+	CFRelease(folded);
+}
+
+CFComparisonResult QCCollationKey::compare(QCCollationKey const &rhs) const
+{
+	return compareUnits(key.empty() ? NULL : &key[0], static_cast<CFIndex>(key.size())
+						, rhs.key.empty() ? NULL : &rhs.key[0], static_cast<CFIndex>(rhs.key.size()));
+}
+
+// static
+void QCCollationKey::sort(std::vector<QCString> &strings, CFLocaleRef const locale)
+{
+	std::vector<QCCollationKey> keys;
+	keys.reserve(strings.size());
+	for (std::vector<QCString>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+	{
+		keys.push_back(QCCollationKey(*it, locale));
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		strings[i] = keys[i].source;
+	}
+}
+
+// static
+void QCCollationKey::sort(QCArray &strings, CFLocaleRef const locale)
+{
+	CFArrayRef const array = strings.Array();
+	CFIndex const count = strings.GetCount();
+	if (count < 2)
+	{
+		return;
+	}
+
+	CFTypeID const stringID = CFStringGetTypeID();
+	std::vector<QCCollationKey> keys;
+	keys.reserve(static_cast<size_t>(count));
+	for (CFIndex i = 0; i < count; ++i)
+	{
+		CFTypeRef const value = CFArrayGetValueAtIndex(array, i);
+		if (isNull(value) || CFGetTypeID(value) != stringID)
+		{
+			throw CFRaiiException(stringID, isNull(value) ? 0 : CFGetTypeID(value));
+		}
+		// QCString adopts its argument, so give it a reference of its own
+		keys.push_back(QCCollationKey(QCString(Retain(static_cast<CFStringRef> (value))), locale));
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<CFTypeRef> sorted(static_cast<size_t>(count));
+	for (CFIndex i = 0; i < count; ++i)
+	{
+		sorted[i] = keys[i].string().CFString();
+	}
+	// written back in place, as QCArray1::stable_sort does, so strings keeps its allocator and ownership
+	strings.ReplaceValues(CFRangeMake(0, count), &sorted[0], count);
+}
+
+END_QC_NAMESPACE
@@ -0,0 +1,95 @@
+/*
+ *  QCStringCompare.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Orderings for sorting many strings.
+ * QCStringOrdinalLess compares UTF-16 code units, reading CF's own buffers directly where it can.
+ * QCCollationKey does the expensive, locale-aware part once per string, so a sort compares plain arrays.
+ */
+
+#ifndef _QC_STRING_COMPARE_GUARD_
+#define _QC_STRING_COMPARE_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <vector>
+#include "CFRaiiCommon.h"
+
+#include "QCString.h"
+#include "QCArray.h"
+
+BEGIN_QC_NAMESPACE
+
+// MARK: -
+// MARK: QCStringOrdinalLess
+
+// for std::sort and friends; a null string sorts before every other string
+struct QCStringOrdinalLess
+{
+	// the same order as CFStringCompare with no options, without its general-purpose machinery
+	static CFComparisonResult compare(CFStringRef const lhs, CFStringRef const rhs);
+
+	// a CFComparatorFunction, for CFArraySortValues and CFArrayBSearchValues on arrays of CFStrings
+	static CFComparisonResult compareValues(void const *lhs, void const *rhs, void *context);
+
+	bool operator () (QCString const &lhs, QCString const &rhs) const
+	{
+		return compare(lhs.CFString(), rhs.CFString()) == kCFCompareLessThan;
+	}
+
+	bool operator () (CFStringRef const lhs, CFStringRef const rhs) const
+	{
+		return compare(lhs, rhs) == kCFCompareLessThan;
+	}
+};
+
+// MARK: -
+// MARK: QCCollationKey
+
+/* A string together with a precomputed sort key.
+ * The key is the string normalized and folded for the locale (case, diacritics and width ignored),
+ * followed by the string's own characters to break ties,
+ * so keys compare like a case- and accent-insensitive localized comparison that is still a total order.
+ * This is a primary-strength approximation built from CFStringFold, not full UCA tailoring.
+ */
+class QCCollationKey
+{
+private:
+	QCString				source;
+	std::vector<UniChar>	key;
+
+public:
+	// a NULL locale folds without locale-specific rules
+	explicit QCCollationKey(QCString const &str, CFLocaleRef const locale = NULL);
+
+	QCString const &string() const
+	{
+		return source;
+	}
+
+	CFComparisonResult compare(QCCollationKey const &rhs) const;
+
+	bool operator < (QCCollationKey const &rhs) const
+	{
+		return compare(rhs) == kCFCompareLessThan;
+	}
+
+	bool operator == (QCCollationKey const &rhs) const
+	{
+		return key == rhs.key;
+	}
+
+	// build every key once, sort the keys, and put the strings back in that order
+	static void sort(std::vector<QCString> &strings, CFLocaleRef const locale = NULL);
+
+	// every element must be a CFString; otherwise CFRaiiException is thrown and the array is unchanged
+	static void sort(QCArray &strings, CFLocaleRef const locale = NULL);
+};
+
+END_QC_NAMESPACE
+
+#endif
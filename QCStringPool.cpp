@@ -0,0 +1,143 @@
+/*
+ *  QCStringPool.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCStringPool.h"
+
+#include <cstring>
+#include <vector>
+
+BEGIN_QC_NAMESPACE
+
+CFDictionaryKeyCallBacks const QCStringPool::kInternedKeyCallBacks =
+{
+	0				// version
+	, NULL			// retain
+	, NULL			// release
+	, CFCopyDescription
+	, NULL			// equal -- pointer equality
+	, NULL			// hash -- the pointer
+};
+
+QCStringPool::QCStringPool()
+: hitCount( 0 )
+, missCount( 0 )
+{ }
+
+// static
+QCStringPool &QCStringPool::shared()
+{
+	// deliberately leaked, so that pooled strings stay valid during static destruction
+	static QCStringPool * const pool = new QCStringPool;
+	return *pool;
+}
+
+// FNV-1a, since C++11 can't hash bytes without first copying them into a std::string
+size_t QCStringPool::BytesHash::operator () (Bytes const &bytes) const
+{
+	UInt64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < bytes.size; ++i)
+	{
+		hash = (hash ^ static_cast<unsigned char> (bytes.data[i])) * 1099511628211ULL;
+	}
+	return static_cast<size_t> (hash);
+}
+
+bool QCStringPool::BytesEqual::operator () (Bytes const &lhs, Bytes const &rhs) const
+{
+	return lhs.size == rhs.size && std::memcmp(lhs.data, rhs.data, lhs.size) == 0;
+}
+
+CFStringRef QCStringPool::intern(char const * const bytes, CFIndex const length)
+{
+	if (bytes == NULL || length < 0)
+	{
+		return NULL;
+	}
+	
+	// points at the caller's bytes, so a hit copies nothing
+	Bytes const key = { bytes, static_cast<size_t>(length) };
+	Shard &shard = shards[BytesHash()(key) % kShardCount];
+	
+	std::lock_guard<std::mutex> guard(shard.lock);
+	
+	Table::const_iterator const found = shard.strings.find(key);
+	if (found != shard.strings.end())
+	{
+		hitCount.fetch_add(1, std::memory_order_relaxed);
+		return found->second;
+	}
+	
+	missCount.fetch_add(1, std::memory_order_relaxed);
+	CFStringRef const str = CFStringCreateWithBytes(kCFAllocatorDefault
+													, reinterpret_cast<UInt8 const *> (bytes)
+													, length
+													, kCFStringEncodingUTF8
+													, false);
+	if (str != NULL)
+	{
+		// the table owns this reference, and the shard the key's bytes, for the life of the process
+		shard.keys.push_back(std::string(bytes, key.size));
+		Bytes const ownKey = { shard.keys.back().data(), key.size };
+		shard.strings.insert(Table::value_type(ownKey, str));
+	}
+	return str;
+}
+
+CFStringRef QCStringPool::intern(char const * const cString)
+{
+	return (cString == NULL) ? NULL : intern(cString, static_cast<CFIndex>(strlen(cString)));
+}
+
+CFStringRef QCStringPool::intern(CFStringRef const &str)
+{
+	if (str == NULL)
+	{
+		return NULL;
+	}
+	
+	// with no loss byte, conversion stops at the first character UTF-8 can't hold,
+	// and interning what came before it would alias a different string
+	CFIndex const length = CFStringGetLength(str);
+	CFIndex byteCount = 0;
+	if (CFStringGetBytes(str, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false, NULL, 0, &byteCount) != length)
+	{
+		return NULL;
+	}
+	
+	// the pointer is NUL-terminated, but the string may hold NULs of its own, so the length comes from the count above
+	char const * const direct = CFStringGetCStringPtr(str, kCFStringEncodingUTF8);
+	if (direct != NULL)
+	{
+		return intern(direct, byteCount);
+	}
+	
+	std::vector<char> buffer(static_cast<size_t>(byteCount) + 1);
+	CFStringGetBytes(str, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false
+					 , reinterpret_cast<UInt8 *> (&buffer[0]), byteCount, NULL);
+	return intern(&buffer[0], byteCount);
+}
+
+CFIndex QCStringPool::count()
+{
+	CFIndex total = 0;
+	for (size_t i = 0; i < kShardCount; ++i)
+	{
+		std::lock_guard<std::mutex> guard(shards[i].lock);
+		total += static_cast<CFIndex>(shards[i].strings.size());
+	}
+	return total;
+}
+
+void QCStringPool::resetStatistics()
+{
+	hitCount.store(0, std::memory_order_relaxed);
+	missCount.store(0, std::memory_order_relaxed);
+}
+
+END_QC_NAMESPACE
@@ -0,0 +1,104 @@
+/*
+ *  QCStringPool.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Process-wide, thread-safe table of canonical CFStrings keyed by their UTF-8 bytes.
+ * Interning the same bytes twice yields the same CFStringRef, so interned strings
+ * compare equal exactly when their pointers are equal.
+ * Pooled strings are never released.
+ */
+
+#ifndef _QC_STRING_POOL_GUARD_
+#define _QC_STRING_POOL_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "CFRaiiCommon.h"
+
+BEGIN_QC_NAMESPACE
+
+class QCStringPool
+{
+private:
+	// UTF-8 bytes that someone else owns: the caller's while looking up, the shard's once in the table
+	struct Bytes
+	{
+		char const *	data;
+		size_t			size;
+	};
+	
+	struct BytesHash
+	{
+		size_t operator () (Bytes const &bytes) const;
+	};
+	
+	struct BytesEqual
+	{
+		bool operator () (Bytes const &lhs, Bytes const &rhs) const;
+	};
+	
+	typedef std::unordered_map<Bytes, CFStringRef, BytesHash, BytesEqual> Table;
+	
+	// lookups on different shards don't contend
+	static size_t const kShardCount = 16;
+	
+	struct Shard
+	{
+		std::mutex	lock;
+		Table		strings;
+		// the bytes the table's keys point at; a deque never moves its elements, so the keys stay valid
+		std::deque<std::string>	keys;
+	};
+	
+	Shard shards[kShardCount];
+	std::atomic<unsigned long long> hitCount;
+	std::atomic<unsigned long long> missCount;
+	
+	QCStringPool();
+	
+	// no copying
+	QCStringPool(QCStringPool const &);
+	QCStringPool & operator = (QCStringPool const &);
+	
+public:
+	// the pool is created on first use and lives until the process exits
+	static QCStringPool &shared();
+	
+	// Return the canonical string for UTF-8 bytes, or NULL if they are not valid UTF-8.
+	// Ownership follows the Get rule: the pool keeps the string alive forever.
+	CFStringRef intern(char const * const bytes, CFIndex const length);
+	CFStringRef intern(char const * const cString);
+	// all of str, embedded NULs included; NULL if it has no exact UTF-8 form (a lone surrogate, say)
+	CFStringRef intern(CFStringRef const &str);
+	
+	// statistics
+	unsigned long long hits() const
+	{
+		return hitCount.load(std::memory_order_relaxed);
+	}
+	unsigned long long misses() const
+	{
+		return missCount.load(std::memory_order_relaxed);
+	}
+	CFIndex count();
+	void resetStatistics();
+	
+	/* Key callbacks for dictionaries whose keys are all interned strings:
+	 * no retain or release (pooled strings are immortal), pointer equality, and the pointer as the hash,
+	 * so lookups never read the characters.
+	 */
+	static CFDictionaryKeyCallBacks const kInternedKeyCallBacks;
+};
+
+END_QC_NAMESPACE
+
+#endif
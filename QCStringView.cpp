@@ -0,0 +1,181 @@
+/*
+ *  QCStringView.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCStringView.h"
+
+BEGIN_QC_NAMESPACE
+
+CFIndex QCStringView::find(UniChar const c, CFIndex const from) const
+{
+	if (null() || from < 0)
+	{
+		return kCFNotFound;
+	}
+
+	CFStringInlineBuffer buffer;
+	CFStringInitInlineBuffer(base, &buffer, span);
+
+	for (CFIndex i = from; i < span.length; ++i)
+	{
+		if (CFStringGetCharacterFromInlineBuffer(&buffer, i) == c)
+		{
+			return i;
+		}
+	}
+	return kCFNotFound;
+}
+
+CFIndex QCStringView::rfind(UniChar const c) const
+{
+	if (null())
+	{
+		return kCFNotFound;
+	}
+
+	CFStringInlineBuffer buffer;
+	CFStringInitInlineBuffer(base, &buffer, span);
+
+	for (CFIndex i = span.length - 1; i >= 0; --i)
+	{
+		if (CFStringGetCharacterFromInlineBuffer(&buffer, i) == c)
+		{
+			return i;
+		}
+	}
+	return kCFNotFound;
+}
+
+std::vector<CFRange> QCStringView::findAll(CFStringRef const &needle, CFOptionFlags const options) const
+{
+	std::vector<CFRange> found;
+	if (null() || isNull(needle) || CFStringGetLength(needle) == 0)
+	{
+		return found;
+	}
+
+	CFRange match;
+	CFIndex location = span.location;
+	CFIndex const end = span.location + span.length;
+	while (location < end
+		   && CFStringFindWithOptions(base, needle, CFRangeMake(location, end - location), options, &match))
+	{
+		location = match.location + std::max<CFIndex>(match.length, 1);
+		match.location -= span.location;
+		found.push_back(match);
+	}
+	return found;
+}
+
+CFComparisonResult QCStringView::compare(QCStringView const &rhs) const
+{
+	CFIndex const common = std::min(span.length, rhs.span.length);
+
+	if (common > 0)
+	{
+		CFStringInlineBuffer lhsBuffer, rhsBuffer;
+		CFStringInitInlineBuffer(base, &lhsBuffer, span);
+		CFStringInitInlineBuffer(rhs.base, &rhsBuffer, rhs.span);
+
+		for (CFIndex i = 0; i < common; ++i)
+		{
+			UniChar const l = CFStringGetCharacterFromInlineBuffer(&lhsBuffer, i);
+			UniChar const r = CFStringGetCharacterFromInlineBuffer(&rhsBuffer, i);
+			if (l != r)
+			{
+				return (l < r) ? kCFCompareLessThan : kCFCompareGreaterThan;
+			}
+		}
+	}
+
+	if (span.length == rhs.span.length) return kCFCompareEqualTo;
+	return (span.length < rhs.span.length) ? kCFCompareLessThan : kCFCompareGreaterThan;
+}
+
+std::vector<QCStringView> QCStringView::split(UniChar const separator) const
+{
+	std::vector<QCStringView> fields;
+	if (null())
+	{
+		return fields;
+	}
+
+	CFStringInlineBuffer buffer;
+	CFStringInitInlineBuffer(base, &buffer, span);
+
+	CFIndex fieldStart = 0;
+	for (CFIndex i = 0; i < span.length; ++i)
+	{
+		if (CFStringGetCharacterFromInlineBuffer(&buffer, i) == separator)
+		{
+			fields.push_back(substr(fieldStart, i - fieldStart));
+			fieldStart = i + 1;
+		}
+	}
+	fields.push_back(substr(fieldStart));
+
+	return fields;
+}
+
+std::vector<QCStringView> QCStringView::split(CFStringRef const &separator) const
+{
+	std::vector<QCStringView> fields;
+	if (null())
+	{
+		return fields;
+	}
+
+	CFIndex const separatorLength = isNull(separator) ? 0 : CFStringGetLength(separator);
+	if (separatorLength == 0)
+	{
+		fields.push_back(*this);
+		return fields;
+	}
+
+	CFIndex fieldStart = 0;
+	for (CFIndex found = find(separator); found != kCFNotFound; found = find(separator, fieldStart))
+	{
+		fields.push_back(substr(fieldStart, found - fieldStart));
+		fieldStart = found + separatorLength;
+	}
+	fields.push_back(substr(fieldStart));
+
+	return fields;
+}
+
+QCStringView QCStringView::trim() const
+{
+	if (null() || empty())
+	{
+		return *this;
+	}
+
+	// predefined sets are owned by CF; nothing to release
+	CFCharacterSetRef const whitespace = CFCharacterSetGetPredefined(kCFCharacterSetWhitespaceAndNewline);
+
+	CFStringInlineBuffer buffer;
+	CFStringInitInlineBuffer(base, &buffer, span);
+
+	CFIndex first = 0;
+	while (first < span.length
+		   && CFCharacterSetIsCharacterMember(whitespace, CFStringGetCharacterFromInlineBuffer(&buffer, first)))
+	{
+		++first;
+	}
+
+	CFIndex last = span.length;
+	while (last > first
+		   && CFCharacterSetIsCharacterMember(whitespace, CFStringGetCharacterFromInlineBuffer(&buffer, last - 1)))
+	{
+		--last;
+	}
+
+	return substr(first, last - first);
+}
+
+END_QC_NAMESPACE
@@ -0,0 +1,184 @@
+/*
+ *  QCStringView.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* A CFStringRef plus a CFRange: a slice of a string that is searched, compared, split and trimmed
+ * in place, without creating any CF objects.
+ * A view neither retains nor copies its string, so it must not outlive it
+ * (nor a QCString it was made from, nor that QCString's next modification).
+ * Indices taken and returned by a view are relative to the start of the view.
+ */
+
+#ifndef _QC_STRING_VIEW_GUARD_
+#define _QC_STRING_VIEW_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <vector>
+#include "CFRaiiCommon.h"
+
+#include "QCString.h"
+
+BEGIN_QC_NAMESPACE
+
+class QCStringView
+{
+private:
+	CFStringRef	base;
+	CFRange		span;
+
+public:
+	QCStringView()
+	: base( NULL )
+	, span( CFRangeMake(0, 0) )
+	{ }
+
+	QCStringView(CFStringRef const &inString)
+	: base( inString )
+	, span( CFRangeMake(0, isNull(inString) ? 0 : CFStringGetLength(inString)) )
+	{ }
+
+	// range must lie within inString
+	QCStringView(CFStringRef const &inString, CFRange const &range)
+	: base( inString )
+	, span( range )
+	{ }
+
+	QCStringView(QCString const &inString)
+	: base( inString.CFString() )
+	, span( CFRangeMake(0, inString.length()) )
+	{ }
+
+	// a temporary QCString would release its string at the end of the full expression, leaving the view dangling
+	QCStringView(QCString &&) = delete;
+
+	CFStringRef CFString() const
+	{
+		return base;
+	}
+
+	// the view's range within CFString()
+	CFRange range() const
+	{
+		return span;
+	}
+
+	bool null() const
+	{
+		return isNull(base);
+	}
+
+	bool empty() const
+	{
+		return span.length == 0;
+	}
+
+	CFIndex length() const
+	{
+		return span.length;
+	}
+
+	UniChar operator [] (CFIndex const index) const
+	{
+		return CFStringGetCharacterAtIndex(base, span.location + index);
+	}
+
+	// clipped to the view; a count of kCFNotFound (or anything too large) means "to the end"
+	QCStringView substr(CFIndex pos, CFIndex count = kCFNotFound) const
+	{
+		pos = std::max<CFIndex>(0, std::min(pos, span.length));
+		if (count < 0 || count > span.length - pos)
+		{
+			count = span.length - pos;
+		}
+		return QCStringView(base, CFRangeMake(span.location + pos, count));
+	}
+
+	// MARK: searching -- each returns a view-relative index or kCFNotFound
+
+	CFIndex find(UniChar const c, CFIndex const from = 0) const;
+	CFIndex rfind(UniChar const c) const;
+
+	CFIndex find(CFStringRef const &needle, CFIndex const from = 0, CFOptionFlags const options = 0) const
+	{
+		if (null() || isNull(needle) || from < 0 || span.length < from)
+		{
+			return kCFNotFound;
+		}
+
+		CFRange found;
+		CFRange const searchRange = CFRangeMake(span.location + from, span.length - from);
+		if (!CFStringFindWithOptions(base, needle, searchRange, options, &found))
+		{
+			return kCFNotFound;
+		}
+		return found.location - span.location;
+	}
+
+	CFIndex rfind(CFStringRef const &needle, CFOptionFlags const options = 0) const
+	{
+		return find(needle, 0, options | kCFCompareBackwards);
+	}
+
+	// every non-overlapping occurrence, as view-relative ranges
+	std::vector<CFRange> findAll(CFStringRef const &needle, CFOptionFlags const options = 0) const;
+
+	bool hasPrefix(CFStringRef const &prefix, CFOptionFlags const options = 0) const
+	{
+		return find(prefix, 0, options | kCFCompareAnchored) != kCFNotFound;
+	}
+
+	bool hasSuffix(CFStringRef const &suffix, CFOptionFlags const options = 0) const
+	{
+		return find(suffix, 0, options | kCFCompareAnchored | kCFCompareBackwards) != kCFNotFound;
+	}
+
+	// MARK: comparison
+
+	// the view against all of rhs, with CFStringCompare's options
+	CFComparisonResult compare(CFStringRef const &rhs, CFOptionFlags const options = 0) const
+	{
+		return CFStringCompareWithOptions(base, rhs, span, options);
+	}
+
+	// literal UTF-16 comparison of two views
+	CFComparisonResult compare(QCStringView const &rhs) const;
+
+	bool operator == (QCStringView const &rhs) const
+	{
+		return span.length == rhs.span.length && compare(rhs) == kCFCompareEqualTo;
+	}
+
+	bool operator != (QCStringView const &rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	bool operator < (QCStringView const &rhs) const
+	{
+		return compare(rhs) == kCFCompareLessThan;
+	}
+
+	// MARK: slicing
+
+	// empty fields are kept, so "a,,b" splits into three views
+	std::vector<QCStringView> split(UniChar const separator) const;
+	std::vector<QCStringView> split(CFStringRef const &separator) const;
+
+	// without leading and trailing whitespace and newlines
+	QCStringView trim() const;
+
+	// the one operation that does create a CF object
+	QCString toString(CFAllocatorRef const allocator = kCFAllocatorDefault) const
+	{
+		return null() ? QCString() : QCString(CFStringCreateWithSubstring(allocator, base, span));
+	}
+};
+
+END_QC_NAMESPACE
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ *  QCTypedArray.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* An array whose elements are all known to be of one CF type.
+ * Every element is checked once, when the array is wrapped or loaded;
+ * after that, access hands back the typed reference with no CFGetTypeID and no branch.
+ * QCTypedArray<QCString>, QCTypedArray<QCNumber> and QCTypedArray<QCDictionary> are supported.
+ */
+
+#ifndef _QC_TYPED_ARRAY_GUARD_
+#define _QC_TYPED_ARRAY_GUARD_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <iterator>
+#include "CFRaiiCommon.h"
+#include "QCUtilities.h"
+
+#include "QCArray.h"
+#include "QCDictionary.h"
+#include "QCNumber.h"
+#include "QCString.h"
+
+BEGIN_QC_NAMESPACE
+
+namespace Detail
+{
+	// the CF type behind each element wrapper; left undefined for wrappers QCTypedArray does not support
+	template < class T >
+	struct TypedArrayElement;
+
+	template < >
+	struct TypedArrayElement < QCString >
+	{
+		typedef CFStringRef ref_type;
+	};
+
+	template < >
+	struct TypedArrayElement < QCNumber >
+	{
+		typedef CFNumberRef ref_type;
+	};
+
+	template < >
+	struct TypedArrayElement < QCDictionary >
+	{
+		typedef CFDictionaryRef ref_type;
+	};
+}
+
+template < class T >
+class QCTypedArray
+{
+public:
+	typedef typename Detail::TypedArrayElement<T>::ref_type	ref_type;
+
+private:
+	QCArray		items;
+
+	// throws CFRaiiException for the first element that is NULL or not a ref_type
+	static void check(QCArray const &array)
+	{
+		CFTypeID const expected = CFTraits<ref_type>::cfid();
+		array.forEachChunk([expected](CFTypeRef const *values, CFIndex const count)
+		{
+			for (CFIndex i = 0; i < count; ++i)
+			{
+				if (isNull(values[i]) || CFGetTypeID(values[i]) != expected)
+				{
+					throw CFRaiiException(expected, isNull(values[i]) ? 0 : CFGetTypeID(values[i]));
+				}
+			}
+		});
+	}
+
+public:
+	QCTypedArray()
+	: items( )
+	{ }
+
+	// shares array, after checking every element
+	explicit QCTypedArray(QCArray const &array)
+	: items( array )
+	{
+		check(items);
+	}
+
+	// an empty array if the file can't be read or doesn't hold an array; throws CFRaiiException as above
+	static QCTypedArray arrayFromFile(QCString const &filePath, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	{
+		return QCTypedArray(QCArray::arrayFromFile(filePath, allocator));
+	}
+
+	// MARK: class const_iterator
+	// QCArray1::const_iterator with the cast done for you
+	class const_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag	iterator_category;
+		typedef ref_type						value_type;
+		typedef CFIndex							difference_type;
+		typedef ref_type const *				pointer;
+		typedef ref_type						reference; // elements are returned by value
+
+	private:
+		QCArray::const_iterator		it;
+
+	public:
+		const_iterator()
+		: it( )
+		{ }
+
+		explicit const_iterator(QCArray::const_iterator const &inIt)
+		: it( inIt )
+		{ }
+
+		// prefix operators
+		const_iterator & operator ++ ()
+		{
+			++ it;
+			return *this;
+		}
+
+		const_iterator & operator -- ()
+		{
+			-- it;
+			return *this;
+		}
+
+		// postfix operators
+		const_iterator operator ++ (int)
+		{
+			return const_iterator(it ++);
+		}
+
+		const_iterator operator -- (int)
+		{
+			return const_iterator(it --);
+		}
+
+		// arithmetic
+		const_iterator & operator += (CFIndex const arg)
+		{
+			it += arg;
+			return *this;
+		}
+
+		const_iterator & operator -= (CFIndex const arg)
+		{
+			it -= arg;
+			return *this;
+		}
+
+		const_iterator operator + (CFIndex const arg) const
+		{
+			return const_iterator(it + arg);
+		}
+
+		const_iterator operator - (CFIndex const arg) const
+		{
+			return const_iterator(it - arg);
+		}
+
+		CFIndex operator - (const_iterator const &rhs) const
+		{
+			return it - rhs.it;
+		}
+
+		friend const_iterator operator + (CFIndex const arg, const_iterator const &rhs)
+		{
+			return rhs + arg;
+		}
+
+		// comparison operators
+		bool operator == (const_iterator const &rhs) const	{ return it == rhs.it; }
+		bool operator != (const_iterator const &rhs) const	{ return it != rhs.it; }
+		bool operator < (const_iterator const &rhs) const	{ return it < rhs.it; }
+		bool operator > (const_iterator const &rhs) const	{ return it > rhs.it; }
+		bool operator <= (const_iterator const &rhs) const	{ return it <= rhs.it; }
+		bool operator >= (const_iterator const &rhs) const	{ return it >= rhs.it; }
+
+		// dereference operators
+		ref_type operator * () const
+		{
+			return static_cast<ref_type> (*it);
+		}
+
+		ref_type operator [] (CFIndex const arg) const
+		{
+			return static_cast<ref_type> (it[arg]);
+		}
+	}; // class const_iterator
+
+	// the checked array; read-only, so nothing can slip an element of another type in
+	QCArray const &array() const
+	{
+		return items;
+	}
+
+	bool null() const
+	{
+		return items.null();
+	}
+
+	CFIndex GetCount() const
+	{
+		return items.GetCount();
+	}
+
+	size_t size() const
+	{
+		return items.size();
+	}
+
+	bool empty() const
+	{
+		return items.empty();
+	}
+
+	// borrowed, like QCArray1::at
+	ref_type at(CFIndex const idx) const
+	{
+		return static_cast<ref_type> (items.at(idx));
+	}
+
+	ref_type operator [] (CFIndex const idx) const
+	{
+		return at(idx);
+	}
+
+	// the element in its wrapper, which holds a reference of its own
+	T value(CFIndex const idx) const
+	{
+		return T(Retain(at(idx)));
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(items.begin());
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(items.end());
+	}
+
+	// the type is known, so there is nothing to check
+	void AppendValue(ref_type const value)
+	{
+		items.AppendValue(value);
+	}
+
+	void AppendValue(T const &value)
+	{
+		items.AppendValue(static_cast<ref_type> (value));
+	}
+};
+
+END_QC_NAMESPACE
+
+#endif
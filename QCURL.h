@@ -23,13 +23,15 @@ BEGIN_QC_NAMESPACE
 class QCURL
 {
 	CFURLRef url;
+	// CFHash of url, once computed (URLs are immutable)
+	mutable std::atomic<CFHashCode> hashCode;
 	
-	CFURLRef CFURLFromPath(CFStringRef const &path, Boolean isDir) const
+	CFURLRef CFURLFromPath(CFStringRef const &path, Boolean isDir, CFAllocatorRef const allocator) const
 	{
 		CFURLRef temp(0);
 		if (path != 0)
 		{
-			temp = CFURLCreateWithFileSystemPath(kCFAllocatorDefault
+			temp = CFURLCreateWithFileSystemPath(allocator
 												 , path
 												 , kCFURLPOSIXPathStyle
 												 , isDir);
@@ -40,16 +42,19 @@ class QCURL
 public:
 	QCURL()
 	: url( NULL )
+	, hashCode( 0 )
 	{ }
 	
 	explicit QCURL(CFURLRef const &inURL)
 	: url( inURL )
+	, hashCode( 0 )
 	{
 		// do not release the URL!
 	}
 	
-	explicit QCURL(CFStringRef const &path, Boolean isDir)
-	: url( CFURLFromPath(path, isDir) )
+	explicit QCURL(CFStringRef const &path, Boolean isDir, CFAllocatorRef const allocator = kCFAllocatorDefault)
+	: url( CFURLFromPath(path, isDir, allocator) )
+	, hashCode( 0 )
 	{
 		// do not release the path string!
 	}
@@ -57,8 +62,18 @@ public:
 	// copy constructor
 	QCURL(QCURL const &inURL)
 	: url( Retain(inURL.url) )
+	, hashCode( inURL.hashCode.load(std::memory_order_relaxed) )
 	{ }
 	
+	// move constructor -- steals inURL's reference; inURL is left null
+	QCURL(QCURL &&inURL) noexcept
+	: url( inURL.url )
+	, hashCode( inURL.hashCode.load(std::memory_order_relaxed) )
+	{
+		inURL.url = NULL;
+		inURL.hashCode.store(0, std::memory_order_relaxed);
+	}
+	
 	~QCURL()
 	{
 		Release(url);
@@ -69,16 +84,47 @@ public:
 		return url == NULL;
 	}
 	
+	CFHashCode hash() const
+	{
+		// relaxed is enough: any thread that computes the hash computes the same value
+		CFHashCode h = hashCode.load(std::memory_order_relaxed);
+		if (h == 0 && url != NULL)
+		{
+			h = CFHash(url);
+			hashCode.store(h, std::memory_order_relaxed);
+		}
+		return h;
+	}
+	
 	// Operators
 	
 	// copy assignment
 	QCURL & operator = (QCURL const &rhs)
 	{
-		Release(url);
+		CFURLRef const oldURL = url;
 		url = Retain(rhs.url);
+		hashCode.store(rhs.hashCode.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		Release(oldURL);
 		return *this;
 	}
 	
+	// move assignment
+	QCURL & operator = (QCURL &&rhs) noexcept
+	{
+		std::swap(url, rhs.url);
+		Detail::swapRelaxed(hashCode, rhs.hashCode);
+		return *this;
+	}
+	
+	// hands the owned reference to the caller (follows the Create rule) and leaves this URL null
+	CFURLRef take() &&
+	{
+		CFURLRef const u = url;
+		url = NULL;
+		hashCode.store(0, std::memory_order_relaxed);
+		return u;
+	}
+	
 	// comparison operators
 	
 	bool operator == (QCURL const &rhs) const
@@ -135,4 +181,6 @@ public:
 
 END_QC_NAMESPACE
 
+QC_STD_HASH(QCURL, CFURLRef)
+
 #endif
@@ -0,0 +1,70 @@
+/*
+ *  CFRaii_test_main.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2011-2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct Case
+	{
+		char const			*name;
+		QCTest::Function	function;
+		bool				benchmark;
+	};
+	
+	// a function-local static, so cases may register from any file's static initializers
+	std::vector<Case> &cases()
+	{
+		static std::vector<Case> all;
+		return all;
+	}
+	
+	// checks may fail on threads a case starts
+	std::atomic<unsigned> failures(0);
+}
+
+QCTest::Registrar::Registrar(char const *name, Function const function, bool const benchmark)
+{
+	Case const c = { name, function, benchmark };
+	cases().push_back(c);
+}
+
+void QCTest::fail(char const *file, int const line, char const *expression)
+{
+	++failures;
+	std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+// usage: "Unit Tests" [--benchmark]
+int main(int argc, char const *argv[])
+{
+	bool const benchmarks = (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0);
+	
+	for (std::vector<Case>::const_iterator it = cases().begin(); it != cases().end(); ++it)
+	{
+		if (it->benchmark && !benchmarks)
+		{
+			continue;
+		}
+		std::printf("%s %s\n", it->benchmark ? "[benchmark]" : "[test]     ", it->name);
+		it->function();
+	}
+	
+	if (failures != 0)
+	{
+		std::fprintf(stderr, "%u check(s) failed\n", failures.load());
+		return 1;
+	}
+	std::printf("all tests passed\n");
+	return 0;
+}
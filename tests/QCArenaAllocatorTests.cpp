@@ -0,0 +1,110 @@
+/*
+ *  QCArenaAllocatorTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <thread>
+#include <vector>
+
+#include "QCArenaAllocator.h"
+#include "QCArray.h"
+#include "QCData.h"
+#include "QCDictionary.h"
+#include "QCSet.h"
+#include "QCString.h"
+
+using namespace QC;
+
+// objects created on one thread and released on another, while other threads keep allocating
+QC_TEST(arenaIsSharedBetweenThreads)
+{
+	int const kThreads = 4;
+	int const kObjects = 10000;
+	UInt8 const bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	
+	ArenaAllocator const arena;
+	std::vector<CFDataRef> made(kThreads * kObjects);
+	
+	std::vector<std::thread> workers;
+	for (int t = 0; t < kThreads; ++t)
+	{
+		workers.push_back(std::thread([&, t]
+		{
+			for (int i = 0; i < kObjects; ++i)
+			{
+				made[t * kObjects + i] = CFDataCreate(arena, bytes, sizeof(bytes));
+			}
+		}));
+	}
+	for (int t = 0; t < kThreads; ++t)
+	{
+		workers[t].join();
+	}
+	QC_CHECK(arena.bytesAllocated() >= kThreads * kObjects * static_cast<CFIndex>(sizeof(bytes)));
+	
+	workers.clear();
+	for (int t = 0; t < kThreads; ++t)
+	{
+		// each thread releases another's objects
+		workers.push_back(std::thread([&, t]
+		{
+			int const other = (t + 1) % kThreads;
+			for (int i = 0; i < kObjects; ++i)
+			{
+				QC_CHECK(CFDataGetLength(made[other * kObjects + i]) == sizeof(bytes));
+				CFRelease(made[other * kObjects + i]);
+			}
+		}));
+	}
+	for (int t = 0; t < kThreads; ++t)
+	{
+		workers[t].join();
+	}
+	QC_CHECK(arena.bytesAllocated() <= arena.bytesReserved());
+}
+
+// a wrapper built on the arena goes on creating from it after handing its object away, and so do its copies
+QC_TEST(wrappersKeepTheirAllocator)
+{
+	ArenaAllocator const arena;
+	UInt8 const byte = 1;
+	
+	QCArray1 array(arena);
+	Release(std::move(array).take());
+	array.AppendValue(kCFBooleanTrue);
+	QC_CHECK(CFGetAllocator(array.Array()) == arena.Allocator());
+	
+	QCDictionary dict(arena);
+	Release(std::move(dict).take());
+	QCDictionary dictCopy(dict);
+	dictCopy.setValue(kCFBooleanTrue, kCFBooleanFalse);
+	QC_CHECK(CFGetAllocator(dictCopy.Dictionary()) == arena.Allocator());
+	
+	QCData data(arena);
+	Release(std::move(data).take());
+	QCData dataCopy;
+	dataCopy = data;
+	dataCopy.AppendBytes(&byte, 1);
+	QC_CHECK(CFGetAllocator(dataCopy.Data()) == arena.Allocator());
+	
+	QCSet set(arena);
+	Release(std::move(set).take());
+	set.add(kCFBooleanTrue);
+	QC_CHECK(CFGetAllocator(set.Set()) == arena.Allocator());
+	
+	QCString text(arena);
+	Release(std::move(text).take());
+	text += "x";
+	QC_CHECK(CFGetAllocator(text.CFString()) == arena.Allocator());
+	
+	// the default constructors still use the default allocator
+	QCString plain;
+	plain += "x";
+	QC_CHECK(CFGetAllocator(plain.CFString()) != arena.Allocator());
+}
@@ -0,0 +1,109 @@
+/*
+ *  QCArrayTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "QCArray.h"
+#include "QCNumber.h"
+
+using namespace QC;
+
+namespace
+{
+	QCArray numbersUpTo(int const count)
+	{
+		QCArray numbers;
+		for (int i = 0; i < count; ++i)
+		{
+			numbers.AppendValue(QCNumber(i));
+		}
+		return numbers;
+	}
+}
+
+// inline and heap spans, and chunks that end exactly on and just past a block boundary
+QC_TEST(bulkAccessSeesEveryElement)
+{
+	QCArray const numbers = numbersUpTo(1025);
+
+	QCArrayValues const few = numbers.values(CFRangeMake(3, 10));
+	QC_CHECK(few.size() == 10);
+	for (CFIndex i = 0; i < few.size(); ++i)
+	{
+		QC_CHECK(few[i] == numbers.at(3 + i));
+	}
+
+	QCArrayValues const all = numbers.values();
+	QC_CHECK(all.size() == numbers.GetCount());
+	QC_CHECK(all[1024] == numbers.at(1024));
+
+	CFIndex seen = 0;
+	bool inOrder = true;
+	numbers.forEachChunk([&](CFTypeRef const *values, CFIndex const count)
+	{
+		for (CFIndex i = 0; i < count; ++i, ++seen)
+		{
+			inOrder = inOrder && values[i] == numbers.at(seen);
+		}
+	});
+	QC_CHECK(seen == numbers.GetCount());
+	QC_CHECK(inOrder);
+
+	bool thrown = false;
+	try
+	{
+		numbers.values(CFRangeMake(1000, 26));
+	}
+	catch (std::out_of_range const &)
+	{
+		thrown = true;
+	}
+	QC_CHECK(thrown);
+}
+
+// one scan of 1M elements: a CF call per element, one CFArrayGetValues into a span, and stack-sized chunks
+QC_BENCHMARK(bulkAccess)
+{
+	int const kCount = 1000000;
+	QCArray const numbers = numbersUpTo(kCount);
+	CFTypeRef const target = numbers.at(kCount / 2);
+	CFIndex found = 0;
+
+	double const perElement = QCTest::seconds([&]
+	{
+		for (CFIndex i = 0; i < numbers.GetCount(); ++i)
+		{
+			found += (numbers.at(i) == target);
+		}
+	});
+	double const span = QCTest::seconds([&]
+	{
+		QCArrayValues const all = numbers.values();
+		for (QCArrayValues::const_iterator it = all.begin(); it != all.end(); ++it)
+		{
+			found += (*it == target);
+		}
+	});
+	double const chunks = QCTest::seconds([&]
+	{
+		numbers.forEachChunk([&](CFTypeRef const *values, CFIndex const count)
+		{
+			for (CFIndex i = 0; i < count; ++i)
+			{
+				found += (values[i] == target);
+			}
+		});
+	});
+
+	std::printf("  at() per element %.2f ns, values() %.2f ns, forEachChunk %.2f ns per element (found %ld)\n"
+				, perElement * 1e9 / kCount, span * 1e9 / kCount, chunks * 1e9 / kCount, static_cast<long>(found));
+}
@@ -0,0 +1,107 @@
+/*
+ *  QCCopyOnWriteTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include "QCArray.h"
+#include "QCData.h"
+#include "QCDictionary.h"
+#include "QCNumber.h"
+#include "QCSet.h"
+#include "QCString.h"
+
+using namespace QC;
+
+namespace
+{
+	/* original must hold a mutable object it owns alone.
+	 * A copy that has gone away leaves the object to original, which then mutates it in place;
+	 * a copy that is still around makes original copy before mutating.
+	 */
+	template < class W, class Mutate >
+	void checkCopyOnWrite(W &original, Mutate mutate)
+	{
+		{
+			W const gone(original);
+		}
+		unsigned long long copies = CopyOnWriteCount();
+		mutate(original);
+		QC_CHECK(CopyOnWriteCount() == copies);
+		
+		W const kept(original);
+		copies = CopyOnWriteCount();
+		mutate(original);
+		QC_CHECK(CopyOnWriteCount() == copies + 1);
+		QC_CHECK(!(kept == original));
+		
+		// and the copy just made is ours alone, so it mutates in place too
+		copies = CopyOnWriteCount();
+		mutate(original);
+		QC_CHECK(CopyOnWriteCount() == copies);
+	}
+}
+
+QC_TEST(copyOnWriteArray)
+{
+	QCArray array;
+	CFArrayRef const before = array.Array();
+	checkCopyOnWrite(array, [](QCArray &a) { a.AppendValue(CFSTR("value")); });
+	QC_CHECK(array.GetCount() == 3);
+	QC_CHECK(array.Array() != before);
+}
+
+QC_TEST(copyOnWriteString)
+{
+	QCString string(QCString("a string that is much too long to be a tagged pointer").copy());
+	string += "!"; // now a mutable string of our own
+	checkCopyOnWrite(string, [](QCString &s) { s += "!"; });
+	QC_CHECK(string.length() == 57);
+}
+
+QC_TEST(copyOnWriteDictionary)
+{
+	QCDictionary dict;
+	int key = 0;
+	checkCopyOnWrite(dict, [&key](QCDictionary &d)
+	{
+		d.setValue(QCNumber(++key), CFSTR("value"));
+	});
+	QC_CHECK(CFDictionaryGetCount(dict) == 3);
+}
+
+QC_TEST(copyOnWriteData)
+{
+	QCData data;
+	UInt8 const byte = 0x2a;
+	checkCopyOnWrite(data, [&byte](QCData &d) { d.AppendBytes(&byte, 1); });
+	QC_CHECK(CFDataGetLength(data) == 3);
+}
+
+QC_TEST(copyOnWriteSet)
+{
+	QCSet set;
+	int member = 0;
+	checkCopyOnWrite(set, [&member](QCSet &s) { s.add(QCNumber(++member)); });
+	QC_CHECK(CFSetGetCount(set) == 3);
+}
+
+// a borrowed array stays borrowed through a copy that has gone away: its caller may still be using it without a retain
+QC_TEST(copyOnWriteBorrowedArray)
+{
+	CFMutableArrayRef const callers = CFArrayCreateMutable(kCFAllocatorDefault, 0, &kCFTypeArrayCallBacks);
+	QCArray array(callers);
+	{
+		QCArray const gone(array);
+	}
+	unsigned long long const copies = CopyOnWriteCount();
+	array.AppendValue(CFSTR("value"));
+	QC_CHECK(CopyOnWriteCount() == copies + 1);
+	QC_CHECK(array.Array() != callers);
+	QC_CHECK(array.GetCount() == 1);
+}
@@ -0,0 +1,141 @@
+/*
+ *  QCMoveTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <utility>
+#include <vector>
+
+#include "QCArray.h"
+#include "QCData.h"
+#include "QCDictionary.h"
+#include "QCNumber.h"
+#include "QCSet.h"
+#include "QCString.h"
+#include "QCURL.h"
+
+using namespace QC;
+
+namespace
+{
+	// too long for a tagged-pointer CFString, so it has a real retain count
+	char const kLongString[] = "a string that is much too long to be a tagged pointer";
+	
+	// a copy holds one more retain on the wrapped object; a move holds none and leaves its source null
+	template < class W >
+	void checkRetains(W const &source, CFTypeRef const ref)
+	{
+		CFIndex const base = CFGetRetainCount(ref);
+		
+		W copied(source);
+		QC_CHECK(CFGetRetainCount(ref) == base + 1);
+		
+		W moved(std::move(copied));
+		QC_CHECK(CFGetRetainCount(ref) == base + 1);
+		QC_CHECK(copied.null());
+		
+		W assigned;
+		assigned = std::move(moved);
+		QC_CHECK(CFGetRetainCount(ref) == base + 1);
+		QC_CHECK(moved.null());
+	}
+	
+	QCString passAlong(QCString s)
+	{
+		return s;
+	}
+}
+
+QC_TEST(movesDoNotRetain)
+{
+	QCString const string(kLongString);
+	checkRetains(string, string.CFString());
+	
+	QCArray const array;
+	checkRetains(array, array.Array());
+	
+	QCDictionary const dict;
+	checkRetains(dict, dict.Dictionary());
+	
+	QCData const data;
+	checkRetains(data, static_cast<CFDataRef> (data));
+	
+	QCSet const set;
+	checkRetains(set, set.Set());
+	
+	// beyond the small-number cache and the tagged-pointer range
+	QCNumber const number(0x7edcba9876543210LL);
+	checkRetains(number, static_cast<CFNumberRef> (number));
+	
+	QCURL const url(string, false);
+	checkRetains(url, static_cast<CFURLRef> (url));
+}
+
+QC_TEST(takeHandsOverTheReference)
+{
+	QCString string(kLongString);
+	CFStringRef const ref = string.CFString();
+	CFIndex const base = CFGetRetainCount(ref);
+	
+	CFStringRef const taken = std::move(string).take();
+	QC_CHECK(taken == ref);
+	QC_CHECK(string.null());
+	QC_CHECK(CFGetRetainCount(ref) == base);
+	CFRelease(taken);
+}
+
+/* Retains and time per hand-off of a temporary, passed along by copy (what every temporary paid
+ * before the move constructors) and by move.
+ * Retains are counted on the string while every link of a chain of hand-offs is still alive.
+ */
+QC_BENCHMARK(retainsPerOperation)
+{
+	int const kHops = 1000000;
+	QCString const source(kLongString);
+	CFStringRef const ref = source.CFString();
+	CFIndex const base = CFGetRetainCount(ref);
+	
+	std::vector<QCString> chain;
+	chain.reserve(kHops + 1);
+	chain.push_back(source);
+	for (int i = 0; i < kHops; ++i)
+	{
+		chain.push_back(chain.back());
+	}
+	double const copyRetains = double(CFGetRetainCount(ref) - base - 1) / kHops;
+	chain.clear();
+	
+	chain.push_back(source);
+	for (int i = 0; i < kHops; ++i)
+	{
+		chain.push_back(passAlong(std::move(chain.back())));
+	}
+	double const moveRetains = double(CFGetRetainCount(ref) - base - 1) / kHops;
+	chain.clear();
+	
+	double const copySeconds = QCTest::seconds([&]
+	{
+		for (int i = 0; i < kHops; ++i)
+		{
+			QCString const first(source);
+			QCString const second(first);
+		}
+	});
+	double const moveSeconds = QCTest::seconds([&]
+	{
+		for (int i = 0; i < kHops; ++i)
+		{
+			QCString first(source);
+			QCString const second(std::move(first));
+		}
+	});
+	
+	std::printf("  copy: %.2f retains per hand-off, %.1f ns per round\n", copyRetains, copySeconds * 1e9 / kHops);
+	std::printf("  move: %.2f retains per hand-off, %.1f ns per round\n", moveRetains, moveSeconds * 1e9 / kHops);
+}
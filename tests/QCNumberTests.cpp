@@ -0,0 +1,115 @@
+/*
+ *  QCNumberTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "QCNumber.h"
+
+using namespace QC;
+
+QC_TEST(smallIntegersShareOneNumber)
+{
+	QCNumber const a(7);
+	QCNumber const b(7);
+	QC_CHECK(static_cast<CFNumberRef> (a) == static_cast<CFNumberRef> (b));
+	QC_CHECK(CFNumberGetType(a) == kCFNumberIntType);
+
+	// int and long long come from separate tables, so each keeps the type it was made with
+	QCNumber const wide(7LL);
+	QC_CHECK(CFNumberGetType(wide) == kCFNumberLongLongType);
+
+	int value = 0;
+	QC_CHECK(CFNumberGetValue(QCNumber(QC_NUMBER_CACHE_MAX + 1), kCFNumberIntType, &value));
+	QC_CHECK(value == QC_NUMBER_CACHE_MAX + 1);
+}
+
+/* A dictionary of 1M small counters, filled once with cached QCNumbers and once with a fresh CFNumber per entry.
+ * The keys are made beforehand, so only the values differ; the distinct-values column is what the cache saves in memory.
+ * Where CF makes small numbers tagged pointers, the CFNumber column has few distinct values too.
+ */
+QC_BENCHMARK(millionCounters)
+{
+	int const kEntries = 1000000;
+	int const kCounterRange = 16;
+
+	std::vector<CFNumberRef> keys(kEntries);
+	for (int i = 0; i < kEntries; ++i)
+	{
+		long long const key = 0x100000000LL + i; // beyond the cache
+		keys[i] = CFNumberCreate(kCFAllocatorDefault, kCFNumberLongLongType, &key);
+	}
+
+	CFMutableDictionaryRef const cachedDict = CFDictionaryCreateMutable(kCFAllocatorDefault, kEntries
+																		, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+	CFMutableDictionaryRef const freshDict = CFDictionaryCreateMutable(kCFAllocatorDefault, kEntries
+																	   , &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+
+	double const cached = QCTest::seconds([&]
+	{
+		for (int i = 0; i < kEntries; ++i)
+		{
+			QCNumber const counter(i % kCounterRange);
+			CFDictionarySetValue(cachedDict, keys[i], counter);
+		}
+	});
+	double const fresh = QCTest::seconds([&]
+	{
+		for (int i = 0; i < kEntries; ++i)
+		{
+			int const value = i % kCounterRange;
+			CFNumberRef const counter = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &value);
+			CFDictionarySetValue(freshDict, keys[i], counter);
+			CFRelease(counter);
+		}
+	});
+
+	std::set<CFTypeRef> cachedValues, freshValues;
+	for (int i = 0; i < kEntries; ++i)
+	{
+		cachedValues.insert(CFDictionaryGetValue(cachedDict, keys[i]));
+		freshValues.insert(CFDictionaryGetValue(freshDict, keys[i]));
+	}
+
+	std::printf("  %-10s %8s %16s\n", "", "ns/entry", "distinct values");
+	std::printf("  %-10s %8.1f %16zu\n", "QCNumber", cached * 1e9 / kEntries, cachedValues.size());
+	std::printf("  %-10s %8.1f %16zu\n", "CFNumber", fresh * 1e9 / kEntries, freshValues.size());
+
+	CFRelease(cachedDict);
+	CFRelease(freshDict);
+	for (int i = 0; i < kEntries; ++i)
+	{
+		CFRelease(keys[i]);
+	}
+}
+
+// the whole unsigned 64-bit range comes back, and nothing negative or fractional sneaks in
+QC_TEST(unsignedValuesRoundTrip)
+{
+	unsigned long long const values[] = { 0, 1, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0xffffffffffffffffULL };
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+	{
+		unsigned long long back = 0;
+		QC_CHECK(QCNumber(values[i]).try_get(back));
+		QC_CHECK(back == values[i]);
+	}
+
+	unsigned int narrow = 0;
+	QC_CHECK(!QCNumber(0x100000000ULL).try_get(narrow));
+
+	unsigned long long back = 0;
+	QC_CHECK(!QCNumber(-1).try_get(back));
+	QC_CHECK(!QCNumber(2.5).try_get(back));
+	QC_CHECK(QCNumber(1e19).try_get(back));
+	QC_CHECK(back == 10000000000000000000ULL);
+	QC_CHECK(!QCNumber(18446744073709551616.0).try_get(back));
+}
@@ -0,0 +1,120 @@
+/*
+ *  QCParallelSortTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "QCArray.h"
+#include "QCNumber.h"
+#include "QCParallelSort.h"
+#include "QCString.h"
+
+using namespace QC;
+
+namespace
+{
+	// count strings of random lowercase letters, some sharing their first four characters so that keys tie
+	QCArray randomStrings(CFIndex const count)
+	{
+		std::srand(12345);
+		QCArray strings;
+		char text[12] = { 0 };
+		for (CFIndex i = 0; i < count; ++i)
+		{
+			size_t const prefix = (i % 4 == 0) ? 4 : 0;
+			for (size_t c = 0; c < sizeof(text) - 1; ++c)
+			{
+				text[c] = (c < prefix) ? 'q' : static_cast<char>('a' + std::rand() % 26);
+			}
+			strings.AppendValue(QCString(text));
+		}
+		return strings;
+	}
+
+	QCArray randomNumbers(CFIndex const count)
+	{
+		std::srand(54321);
+		QCArray numbers;
+		for (CFIndex i = 0; i < count; ++i)
+		{
+			numbers.AppendValue(QCNumber(static_cast<long long>(std::rand()) - RAND_MAX / 2));
+		}
+		return numbers;
+	}
+
+	// a copy of array that is already ours to modify, so the copy isn't part of what gets timed
+	QCArray unsharedCopy(QCArray const &array)
+	{
+		QCArray copy(array);
+		copy.makeMutable();
+		copy.makeUnique();
+		return copy;
+	}
+
+	bool sameElements(QCArray const &lhs, QCArray const &rhs)
+	{
+		if (lhs.GetCount() != rhs.GetCount()) return false;
+		for (CFIndex i = 0; i < lhs.GetCount(); ++i)
+		{
+			if (CFEqual(lhs.at(i), rhs.at(i)) == false) return false;
+		}
+		return true;
+	}
+}
+
+// enough elements for four threads, so the merges run too; the order must be exactly QCArray::sort's
+QC_TEST(parallelSortMatchesSort)
+{
+	CFIndex const count = 4 * QCParallelSort::kMinimumPerThread + 17;
+
+	QCArray const strings = randomStrings(count);
+	QCArray expected = unsharedCopy(strings);
+	expected.sort(QCStringOrdinalLess());
+	QCArray sorted = unsharedCopy(strings);
+	QCParallelSort::sort(sorted, QCStringOrdinalLess(), 4);
+	QC_CHECK(sameElements(sorted, expected));
+
+	QCArray const numbers = randomNumbers(count);
+	QCArray expectedNumbers = unsharedCopy(numbers);
+	expectedNumbers.sort(QCNumberLess());
+	QCArray sortedNumbers = unsharedCopy(numbers);
+	QCParallelSort::sort(sortedNumbers, QCNumberLess(), 4);
+	QC_CHECK(sameElements(sortedNumbers, expectedNumbers));
+}
+
+/* 1M strings and 1M numbers sorted on 1, 2, 4, 8 and 16 threads, against QCArray::sort.
+ * Past the number of cores the time should level off rather than climb.
+ */
+QC_BENCHMARK(parallelSortScaling)
+{
+	CFIndex const kCount = 1000000;
+	unsigned const kThreadCounts[] = { 1, 2, 4, 8, 16 };
+
+	QCArray const strings = randomStrings(kCount);
+	QCArray const numbers = randomNumbers(kCount);
+
+	QCArray work = unsharedCopy(strings);
+	double const stringSort = QCTest::seconds([&] { work.sort(QCStringOrdinalLess()); });
+	work = unsharedCopy(numbers);
+	double const numberSort = QCTest::seconds([&] { work.sort(QCNumberLess()); });
+
+	std::printf("  %-18s %10s %10s\n", "", "strings ms", "numbers ms");
+	std::printf("  %-18s %10.1f %10.1f\n", "QCArray::sort", stringSort * 1e3, numberSort * 1e3);
+	for (size_t i = 0; i < sizeof(kThreadCounts) / sizeof(kThreadCounts[0]); ++i)
+	{
+		unsigned const threads = kThreadCounts[i];
+		work = unsharedCopy(strings);
+		double const parallelStrings = QCTest::seconds([&] { QCParallelSort::sort(work, QCStringOrdinalLess(), threads); });
+		work = unsharedCopy(numbers);
+		double const parallelNumbers = QCTest::seconds([&] { QCParallelSort::sort(work, QCNumberLess(), threads); });
+		std::printf("  %2u thread(s)        %10.1f %10.1f\n", threads, parallelStrings * 1e3, parallelNumbers * 1e3);
+	}
+}
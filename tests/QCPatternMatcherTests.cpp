@@ -0,0 +1,47 @@
+/*
+ *  QCPatternMatcherTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include "QCArray.h"
+#include "QCNumber.h"
+#include "QCPatternMatcher.h"
+#include "QCUtilities.h"
+
+using namespace QC;
+
+QC_TEST(matcherBuiltFromAnArray)
+{
+	QCArray patterns;
+	patterns.AppendValue(CFSTR("he"));
+	patterns.AppendValue(CFSTR("she"));
+	
+	QCPatternMatcher const matcher(patterns.Array());
+	QC_CHECK(matcher.count() == 2);
+	QC_CHECK(matcher.findAll(QCStringView(CFSTR("ushers"))).size() == 2);
+}
+
+// an element that isn't a string is reported, not cast and read as one
+QC_TEST(matcherRejectsNonStringPatterns)
+{
+	QCArray patterns;
+	patterns.AppendValue(CFSTR("he"));
+	patterns.AppendValue(QCNumber(12345678901LL));
+	
+	bool thrown = false;
+	try
+	{
+		QCPatternMatcher const matcher(patterns.Array());
+	}
+	catch (CFRaiiException &)
+	{
+		thrown = true;
+	}
+	QC_CHECK(thrown);
+}
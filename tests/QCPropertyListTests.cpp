@@ -0,0 +1,65 @@
+/*
+ *  QCPropertyListTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <cstdio>
+
+#include "QCArray.h"
+#include "QCDictionary.h"
+#include "QCNumber.h"
+#include "QCString.h"
+
+using namespace QC;
+
+// a loaded plist is held mutably, so count() and writeToFile() must see it there
+QC_TEST(dictionaryFileRoundTrip)
+{
+	char const *const path = "/tmp/QCPropertyListTests-dictionary.plist";
+
+	QCDictionary original;
+	original.setValue(QCString("one"), QCNumber(1));
+	original.setValue(QCString("two"), QCNumber(2));
+	QC_CHECK(original.writeToFile(QCString(path)));
+
+	QCDictionary const loaded = QCDictionary::dictionaryFromFile(QCString(path));
+	QC_CHECK(loaded.count() == 2);
+	QC_CHECK(loaded.writeToFile(QCString(path)));
+
+	QCDictionary const reloaded = QCDictionary::dictionaryFromFile(QCString(path));
+	QC_CHECK(reloaded.count() == 2);
+	QC_CHECK(CFEqual(static_cast<CFDictionaryRef> (reloaded), static_cast<CFDictionaryRef> (original)));
+
+	std::remove(path);
+}
+
+QC_TEST(arrayFileRoundTrip)
+{
+	char const *const path = "/tmp/QCPropertyListTests-array.plist";
+
+	QCArray original;
+	original.AppendValue(QCString("one"));
+	original.AppendValue(QCNumber(2));
+	QC_CHECK(original.writeToFile(QCString(path), kCFPropertyListXMLFormat_v1_0));
+
+	QCArray const loaded = QCArray::arrayFromFile(QCString(path));
+	QC_CHECK(loaded.GetCount() == 2);
+	QC_CHECK(loaded.writeToFile(QCString(path), kCFPropertyListBinaryFormat_v1_0));
+
+	QCArray const reloaded = QCArray::arrayFromFile(QCString(path));
+	QC_CHECK(reloaded.GetCount() == 2);
+	QC_CHECK(CFEqual(static_cast<CFArrayRef> (reloaded), static_cast<CFArrayRef> (original)));
+
+	// appending a loaded array must not skip it for being held mutably
+	QCArray appended;
+	appended += loaded;
+	QC_CHECK(appended.GetCount() == 2);
+
+	std::remove(path);
+}
@@ -0,0 +1,79 @@
+/*
+ *  QCRefTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <vector>
+
+#include "QCRef.h"
+#include "QCSharedPtr.h"
+
+using namespace QC;
+
+namespace
+{
+	// created rather than a CFSTR constant, which ignores retains; too long to be a tagged pointer
+	CFStringRef const kString = CFStringCreateWithCString(kCFAllocatorDefault
+														 , "a string that is much too long to be a tagged pointer"
+														 , kCFStringEncodingUTF8);
+	
+	// a +1 reference for a smart pointer to adopt
+	CFStringRef retained()
+	{
+		return static_cast<CFStringRef> (CFRetain(kString));
+	}
+}
+
+QC_TEST(refBalancesRetains)
+{
+	CFIndex const base = CFGetRetainCount(kString);
+	{
+		QCRef<CFStringRef> const adopted(retained());
+		QCRef<CFStringRef> const shared(QCRef<CFStringRef>::retaining(kString));
+		QCRef<CFStringRef> const copied(adopted);
+		QCRef<CFTypeRef> const widened(copied);
+		QC_CHECK(adopted.get() == kString);
+		QC_CHECK(adopted.GetRetainCount() == base + 4);
+	}
+	QC_CHECK(CFGetRetainCount(kString) == base);
+}
+
+/* Construction (adopting a +1 reference), copy and destruction, QCRef against QCSharedPtr.
+ * QCSharedPtr allocates a control block per construction and moves two words per copy.
+ */
+QC_BENCHMARK(refAgainstSharedPtr)
+{
+	int const kCount = 1000000;
+	typedef QCSharedPtr<CFStringRef> SharedPtr;
+	
+	std::vector<QCRef<CFStringRef> > refs;
+	std::vector<SharedPtr> sharedPtrs;
+	refs.reserve(kCount);
+	sharedPtrs.reserve(kCount);
+	
+	double const refConstruct = QCTest::seconds([&] { for (int i = 0; i < kCount; ++i) refs.push_back(QCRef<CFStringRef>(retained())); });
+	double const sharedConstruct = QCTest::seconds([&] { for (int i = 0; i < kCount; ++i) sharedPtrs.push_back(SharedPtr(retained())); });
+	
+	std::vector<QCRef<CFStringRef> > refCopies;
+	std::vector<SharedPtr> sharedCopies;
+	refCopies.reserve(kCount);
+	sharedCopies.reserve(kCount);
+	
+	double const refCopy = QCTest::seconds([&] { for (int i = 0; i < kCount; ++i) refCopies.push_back(refs[i]); });
+	double const sharedCopy = QCTest::seconds([&] { for (int i = 0; i < kCount; ++i) sharedCopies.push_back(sharedPtrs[i]); });
+	
+	double const refDestroy = QCTest::seconds([&] { refCopies.clear(); refs.clear(); });
+	double const sharedDestroy = QCTest::seconds([&] { sharedCopies.clear(); sharedPtrs.clear(); });
+	
+	std::printf("  %-12s %5s %12s %8s %12s\n", "", "bytes", "construct ns", "copy ns", "2x destroy ns");
+	std::printf("  %-12s %5zu %12.1f %8.1f %12.1f\n", "QCRef", sizeof(QCRef<CFStringRef>)
+				, refConstruct * 1e9 / kCount, refCopy * 1e9 / kCount, refDestroy * 1e9 / kCount);
+	std::printf("  %-12s %5zu %12.1f %8.1f %12.1f\n", "QCSharedPtr", sizeof(SharedPtr)
+				, sharedConstruct * 1e9 / kCount, sharedCopy * 1e9 / kCount, sharedDestroy * 1e9 / kCount);
+}
@@ -0,0 +1,54 @@
+/*
+ *  QCStringPoolTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include "QCStringPool.h"
+
+using namespace QC;
+
+QC_TEST(equalBytesInternToOneString)
+{
+	QCStringPool &pool = QCStringPool::shared();
+	CFStringRef const first = pool.intern("pooled");
+
+	CFStringRef const str = CFStringCreateWithCString(kCFAllocatorDefault, "pooled", kCFStringEncodingUTF8);
+	QC_CHECK(first != NULL);
+	QC_CHECK(pool.intern(str) == first);
+	QC_CHECK(pool.intern("pooled", 6) == first);
+	CFRelease(str);
+}
+
+// the whole string is the key, not just the bytes before its first NUL
+QC_TEST(embeddedNulsArePartOfTheKey)
+{
+	QCStringPool &pool = QCStringPool::shared();
+	char const bytes[] = { 'a', '\0', 'b' };
+
+	CFStringRef const str = CFStringCreateWithBytes(kCFAllocatorDefault, reinterpret_cast<UInt8 const *> (bytes)
+													, sizeof(bytes), kCFStringEncodingUTF8, false);
+	CFStringRef const interned = pool.intern(str);
+	QC_CHECK(interned != NULL);
+	QC_CHECK(interned != pool.intern("a"));
+	QC_CHECK(interned == pool.intern(bytes, sizeof(bytes)));
+	QC_CHECK(CFStringGetLength(interned) == 3);
+	CFRelease(str);
+}
+
+// a lone surrogate has no UTF-8 form; interning the characters before it would alias another string
+QC_TEST(unconvertibleStringsAreRefused)
+{
+	QCStringPool &pool = QCStringPool::shared();
+	UniChar const characters[] = { 'a', 0xD800 };
+
+	CFStringRef const str = CFStringCreateWithCharacters(kCFAllocatorDefault, characters, 2);
+	QC_CHECK(pool.intern(str) == NULL);
+	QC_CHECK(pool.intern("a") != NULL);
+	CFRelease(str);
+}
@@ -0,0 +1,144 @@
+/*
+ *  QCStringTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "QCString.h"
+#include "QCStringBuilder.h"
+#include "QCStringView.h"
+
+using namespace QC;
+
+namespace
+{
+	char const kFragment[] = "fragment/";
+	CFIndex const kFragmentLength = sizeof(kFragment) - 1;
+}
+
+QC_TEST(appendsBuildTheWholeString)
+{
+	QCString string;
+	QCStringBuilder builder(100 * kFragmentLength);
+	for (int i = 0; i < 100; ++i)
+	{
+		string += kFragment;
+		builder += kFragment;
+	}
+	QC_CHECK(string.length() == 100 * kFragmentLength);
+	QC_CHECK(builder.build() == string);
+}
+
+// views of encoded bytes own them, so one utf8() call can't pull the rug from under another
+QC_TEST(utf8ViewsStayValid)
+{
+	QCString const first(std::string("caf\xc3\xa9 one"));
+	QCString const second(std::string("caf\xc3\xa9 two"));
+	
+	QCUTF8View const firstView = first.utf8();
+	QCUTF8View const secondView = second.utf8();
+	QC_CHECK(firstView.str() == "caf\xc3\xa9 one");
+	QC_CHECK(secondView.str() == "caf\xc3\xa9 two");
+	
+	QCUTF8View copied(firstView);
+	QC_CHECK(copied.str() == firstView.str());
+	
+	// the whole string, not just the bytes before its NUL
+	QCString const withNul(std::string("a\0b", 3));
+	QC_CHECK(withNul.utf8().size() == 3);
+}
+
+QC_TEST(fromBytesKeepsEveryByte)
+{
+	QCString const withNul = QCString::fromBytes("a\0b", 3);
+	QC_CHECK(withNul.length() == 3);
+	QC_CHECK(QCString::fromBytes("abc", 0).length() == 0);
+	QC_CHECK(QCString::fromBytes("\xff", 1).null()); // not UTF-8
+	QC_CHECK(QCString::fromBytes(NULL, 3).null());
+}
+
+// toStdString() and appendTo() keep embedded NULs, and turn a lone surrogate into '?' rather than stopping at it
+QC_TEST(toStdStringKeepsEveryCharacter)
+{
+	QC_CHECK(QCString::fromBytes("a\0b", 3).toStdString() == std::string("a\0b", 3));
+	
+	std::string out("x");
+	QCString(std::string("caf\xc3\xa9\0!", 7)).appendTo(out);
+	QC_CHECK(out == std::string("xcaf\xc3\xa9\0!", 8));
+	
+	UniChar const characters[] = { 0xE9, 0xD800, 'z' };
+	CFStringRef const surrogate = CFStringCreateWithCharacters(kCFAllocatorDefault, characters, 3);
+	QC_CHECK(QCString(surrogate).toStdString() == "\xc3\xa9?z");
+}
+
+// std::hash may call hash() on one string from many threads at once; the cached value is shared safely
+QC_TEST(hashIsSafeToShare)
+{
+	QCString const string(std::string("a string long enough to hash the slow way"));
+	CFHashCode const expected = CFHash(string.CFString());
+	
+	std::vector<CFHashCode> seen(4);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < seen.size(); ++t)
+	{
+		workers.push_back(std::thread([&string, &seen, t] { seen[t] = string.hash(); }));
+	}
+	for (size_t t = 0; t < workers.size(); ++t)
+	{
+		workers[t].join();
+		QC_CHECK(seen[t] == expected);
+	}
+	QC_CHECK(string.hash() == expected);
+}
+
+// n + it works as well as it + n, as random access iterators require
+QC_TEST(iteratorArithmeticCommutes)
+{
+	QCString const string("abcdef");
+	QCString::const_iterator const it = string.begin();
+	QC_CHECK(*(2 + it) == 'c');
+	QC_CHECK(2 + it == it + 2);
+	QC_CHECK(string.end() - (3 + it) == 3);
+}
+
+// a view of a temporary would dangle as soon as the temporary's full expression ends
+static_assert(std::is_constructible<QCStringView, QCString &>::value, "views of QCString lvalues are allowed");
+static_assert(!std::is_constructible<QCStringView, QCString>::value, "views of QCString temporaries must not compile");
+
+/* Time to concatenate n fragments, for n doubling up to 10k.
+ * With in-place appends the time per fragment stays flat; a copy per append would double it at every step.
+ */
+QC_BENCHMARK(linearAppends)
+{
+	for (int count = 625; count <= 10000; count *= 2)
+	{
+		double const appendSeconds = QCTest::seconds([count]
+		{
+			QCString string;
+			for (int i = 0; i < count; ++i)
+			{
+				string += kFragment;
+			}
+		});
+		double const builderSeconds = QCTest::seconds([count]
+		{
+			QCStringBuilder builder(count * kFragmentLength);
+			for (int i = 0; i < count; ++i)
+			{
+				builder += kFragment;
+			}
+			QCString const string(builder.build());
+		});
+		std::printf("  %5d fragments: += %.1f ns, QCStringBuilder %.1f ns per fragment\n"
+					, count, appendSeconds * 1e9 / count, builderSeconds * 1e9 / count);
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ *  QCTest.h
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+/* Just enough of a test runner for the Unit Tests target.
+ * QC_TEST cases always run; QC_BENCHMARK cases run only when the tool is passed --benchmark,
+ * and print their measurements instead of checking them.
+ */
+
+#ifndef _QC_TEST_GUARD_
+#define _QC_TEST_GUARD_
+
+#include <chrono>
+#include <cstdio>
+
+namespace QCTest
+{
+	typedef void (*Function)();
+	
+	// adds a case to the list CFRaii_test_main.cpp runs
+	struct Registrar
+	{
+		Registrar(char const *name, Function const function, bool const benchmark);
+	};
+	
+	// records a failed QC_CHECK; the case carries on
+	void fail(char const *file, int const line, char const *expression);
+	
+	// seconds taken by f()
+	template < class F >
+	double seconds(F f)
+	{
+		std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+		f();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+#define QC_TEST(name) \
+static void name(); \
+static QCTest::Registrar const name##Registrar(#name, &name, false); \
+static void name()
+
+#define QC_BENCHMARK(name) \
+static void name(); \
+static QCTest::Registrar const name##Registrar(#name, &name, true); \
+static void name()
+
+#define QC_CHECK(expression) \
+do { if (!(expression)) QCTest::fail(__FILE__, __LINE__, #expression); } while (0)
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ *  QCTypedArrayTests.cpp
+ *  CFRaii
+ *
+ * Copyright (c) 2026 Richard A. Brown
+ *
+ * See license.txt for licensing terms and conditions.
+ */
+
+#include "QCTest.h"
+
+#include <cstdio>
+
+#include "QCArray.h"
+#include "QCNumber.h"
+#include "QCString.h"
+#include "QCTypedArray.h"
+#include "QCUtilities.h"
+
+using namespace QC;
+
+namespace
+{
+	QCArray stringsAndA(CFTypeRef const last)
+	{
+		QCArray array;
+		array.AppendValue(QCString("zero"));
+		array.AppendValue(QCString("one"));
+		array.AppendValue(last);
+		return array;
+	}
+}
+
+QC_TEST(typedArrayHandsBackStrings)
+{
+	QCArray const array = stringsAndA(QCString("two"));
+	QCTypedArray<QCString> const strings(array);
+	QC_CHECK(strings.GetCount() == 3);
+
+	CFStringRef const first = strings.at(0);
+	QC_CHECK(CFStringCompare(first, CFSTR("zero"), 0) == kCFCompareEqualTo);
+	QC_CHECK(strings[2] == array.at(2));
+
+	CFIndex seen = 0;
+	for (QCTypedArray<QCString>::const_iterator it = strings.begin(); it != strings.end(); ++it, ++seen)
+	{
+		QC_CHECK(*it == array.at(seen));
+	}
+	QC_CHECK(seen == 3);
+	QC_CHECK(strings.end() - strings.begin() == 3);
+
+	QCString const one = strings.value(1);
+	QC_CHECK(one == QCString("one"));
+}
+
+// one element of another type is enough to refuse the whole array
+QC_TEST(typedArrayRefusesOtherTypes)
+{
+	bool thrown = false;
+	try
+	{
+		QCTypedArray<QCString> const strings(stringsAndA(QCNumber(2)));
+	}
+	catch (CFRaiiException &)
+	{
+		thrown = true;
+	}
+	QC_CHECK(thrown);
+}
+
+QC_TEST(typedArrayChecksLoadedFiles)
+{
+	char const *const path = "/tmp/QCTypedArrayTests-mixed.plist";
+	QC_CHECK(stringsAndA(QCNumber(2)).writeToFile(QCString(path), kCFPropertyListXMLFormat_v1_0));
+
+	bool thrown = false;
+	try
+	{
+		QCTypedArray<QCString>::arrayFromFile(QCString(path));
+	}
+	catch (CFRaiiException &)
+	{
+		thrown = true;
+	}
+	QC_CHECK(thrown);
+
+	// and the same file is fine for an untyped array
+	QC_CHECK(QCArray::arrayFromFile(QCString(path)).GetCount() == 3);
+
+	std::remove(path);
+}